@@ -92,6 +92,19 @@ Stage0 += environment(variables={
 })
 #Stage0 += copy(src='labs/', dest='/labs/')
 Stage0 += copy(src='include/cartesian_product.hpp', dest='/usr/include/cartesian_product.hpp')
+Stage0 += copy(src='include/bitmap.hpp', dest='/usr/include/bitmap.hpp')
+Stage0 += copy(src='include/compact.hpp', dest='/usr/include/compact.hpp')
+Stage0 += copy(src='include/predicates.hpp', dest='/usr/include/predicates.hpp')
+Stage0 += copy(src='include/histogram.hpp', dest='/usr/include/histogram.hpp')
+Stage0 += copy(src='include/select.hpp', dest='/usr/include/select.hpp')
+Stage0 += copy(src='include/topk.hpp', dest='/usr/include/topk.hpp')
+Stage0 += copy(src='include/random.hpp', dest='/usr/include/random.hpp')
+Stage0 += copy(src='include/rle.hpp', dest='/usr/include/rle.hpp')
+Stage0 += copy(src='include/hash_set.hpp', dest='/usr/include/hash_set.hpp')
+Stage0 += copy(src='include/workspace.hpp', dest='/usr/include/workspace.hpp')
+Stage0 += copy(src='include/packed.hpp', dest='/usr/include/packed.hpp')
+Stage0 += copy(src='include/stencil.hpp', dest='/usr/include/stencil.hpp')
+Stage0 += copy(src='include/layouts.hpp', dest='/usr/include/layouts.hpp')
 Stage0 += copy(src='include/ranges', dest=f'/usr/include/c++/{gcc_ver}/ranges')
 
 Stage0 += environment(variables={
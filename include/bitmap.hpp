@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Selection bitmaps and selection vectors for late materialization.
+//!
+//! Instead of copying the selected values after every filter, predicates produce a packed
+//! bitmap (1 bit per element). Bitmaps are cheap to combine with AND/OR, and the selected
+//! values of any number of columns are only gathered once, at the end.
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+namespace hpc {
+
+// Packed bitmap: bit `i % 64` of word `i / 64` is set if element `i` is selected.
+struct bitmap {
+  static constexpr std::size_t bits = 64;
+  std::vector<std::uint64_t> words;
+  std::size_t size = 0;
+
+  void resize(std::size_t n) {
+    size = n;
+    words.resize(nwords(n));
+  }
+  bool test(std::size_t i) const { return (words[i / bits] >> (i % bits)) & 1; }
+
+  static constexpr std::size_t nwords(std::size_t n) { return (n + bits - 1) / bits; }
+};
+
+// Sets bit `i` of `b` to `pred(v[i])`.
+// Each word is built in registers without branches, so the predicate result is written with
+// 1 bit per element instead of the 32 bits needed to materialize an `int`.
+template <std::ranges::contiguous_range R, class UnaryPredicate>
+void select_bitmap(const R& v, UnaryPredicate pred, bitmap& b) {
+  auto n = std::ranges::size(v);
+  b.resize(n);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), b.words.size(),
+                  [pred, v = std::ranges::data(v), w = b.words.data(), n](std::size_t i) {
+                    auto first = i * bitmap::bits;
+                    auto last = std::min(first + bitmap::bits, n);
+                    std::uint64_t word = 0;
+                    for (auto j = first; j < last; ++j) {
+                      word |= std::uint64_t(pred(v[j]) ? 1 : 0) << (j - first);
+                    }
+                    w[i] = word;
+                  });
+}
+
+// Element-wise combination of two bitmaps of the same size. `out` may alias `a` or `b`.
+template <class BinaryOp>
+void bitmap_combine(const bitmap& a, const bitmap& b, bitmap& out, BinaryOp op) {
+  assert(a.size == b.size);
+  out.resize(a.size);
+  std::transform(std::execution::par, a.words.begin(), a.words.end(), b.words.begin(),
+                 out.words.begin(), op);
+}
+inline void bitmap_and(const bitmap& a, const bitmap& b, bitmap& out) {
+  bitmap_combine(a, b, out, std::bit_and<>{});
+}
+inline void bitmap_or(const bitmap& a, const bitmap& b, bitmap& out) {
+  bitmap_combine(a, b, out, std::bit_or<>{});
+}
+
+// Number of selected elements.
+inline std::size_t count(const bitmap& b) {
+  return std::transform_reduce(std::execution::par, b.words.begin(), b.words.end(), std::size_t{0},
+                               std::plus{}, [](std::uint64_t w) { return std::popcount(w); });
+}
+
+// Writes to `offsets[i]` the output position of the first selected element of word `i`,
+// and returns the total number of selected elements.
+// This is the only scan needed for late materialization, and it runs over 1/64th of the data.
+inline std::size_t word_offsets(const bitmap& b, std::vector<std::size_t>& offsets) {
+  offsets.resize(b.words.size());
+  if (b.words.empty()) return 0;
+  std::transform_exclusive_scan(std::execution::par, b.words.begin(), b.words.end(),
+                                offsets.begin(), std::size_t{0}, std::plus{},
+                                [](std::uint64_t w) { return (std::size_t)std::popcount(w); });
+  return offsets.back() + std::popcount(b.words.back());
+}
+
+// Converts a bitmap into a 32-bit selection vector: the sorted indices of the selected elements.
+inline void to_selection_vector(const bitmap& b, std::vector<std::size_t>& offsets,
+                                std::vector<std::uint32_t>& sel) {
+  assert(b.size <= std::numeric_limits<std::uint32_t>::max());
+  sel.resize(word_offsets(b, offsets));
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), b.words.size(),
+                  [w = b.words.data(), o = offsets.data(), sel = sel.data()](std::size_t i) {
+                    auto word = w[i];
+                    auto out = sel + o[i];
+                    while (word != 0) {
+                      *out++ = (std::uint32_t)(i * bitmap::bits + std::countr_zero(word));
+                      word &= word - 1; // Clear lowest set bit
+                    }
+                  });
+}
+
+// Gathers the elements of `column` at the indices of the selection vector `sel` into `out`.
+template <std::ranges::contiguous_range R, class T>
+void gather(const R& column, const std::vector<std::uint32_t>& sel, std::vector<T>& out) {
+  out.resize(sel.size());
+  std::transform(std::execution::par, sel.begin(), sel.end(), out.begin(),
+                 [c = std::ranges::data(column)](std::uint32_t i) { return c[i]; });
+}
+
+// Gathers the elements of `column` selected by `b` into `out`.
+// `offsets` must have been computed from `b` with `word_offsets`, so that it can be reused
+// to gather any number of columns with the same selection.
+template <std::ranges::contiguous_range R, class T>
+void gather(const R& column, const bitmap& b, const std::vector<std::size_t>& offsets,
+            std::vector<T>& out) {
+  assert(std::ranges::size(column) == b.size && offsets.size() == b.words.size());
+  out.resize(b.words.empty() ? 0 : offsets.back() + std::popcount(b.words.back()));
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), b.words.size(),
+                  [c = std::ranges::data(column), w = b.words.data(), o = offsets.data(),
+                   out = out.data()](std::size_t i) {
+                    auto word = w[i];
+                    auto dst = out + o[i];
+                    while (word != 0) {
+                      *dst++ = c[i * bitmap::bits + std::countr_zero(word)];
+                      word &= word - 1;
+                    }
+                  });
+}
+
+} // namespace hpc
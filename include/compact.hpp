@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! In-place parallel stream compaction.
+
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+namespace hpc {
+
+// Stable parallel `remove_if` that compacts `v` in place and returns the number of kept elements.
+//
+// The input is processed in rounds of `nblocks` blocks of `block` elements. Within a round, each
+// block is compacted into its own slot of `scratch`, an exclusive scan of the per-block counts
+// yields the output offsets, and the slots are copied back to the front of `v`. Since the
+// output never overtakes the round being read, only `nblocks * block` elements of scratch are
+// needed, independently of the size of `v`. `block` and `nblocks` are raised to at least 1.
+template <class T, class UnaryPredicate>
+std::size_t remove_if(std::vector<T>& v, UnaryPredicate pred, std::vector<T>& scratch,
+                      std::size_t block = std::size_t{1} << 16,
+                      std::size_t nblocks = std::max(1u, std::thread::hardware_concurrency())) {
+  // Empty rounds would never advance through `v`:
+  block = std::max(block, std::size_t{1});
+  nblocks = std::max(nblocks, std::size_t{1});
+  auto n = v.size();
+  scratch.resize(nblocks * block);
+  std::vector<std::size_t> counts(nblocks), offsets(nblocks);
+  std::size_t out = 0;
+  for (std::size_t first = 0; first < n; first += nblocks * block) {
+    auto nb = std::min(nblocks, (n - first + block - 1) / block);
+    std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nb,
+                    [=, v = v.data(), s = scratch.data(), c = counts.data()](std::size_t i) {
+                      auto b = first + i * block;
+                      auto e = std::min(b + block, n);
+                      c[i] = std::remove_copy_if(v + b, v + e, s + i * block, pred) - (s + i * block);
+                    });
+    std::exclusive_scan(counts.begin(), counts.begin() + nb, offsets.begin(), out);
+    std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nb,
+                    [=, v = v.data(), s = scratch.data(), c = counts.data(),
+                     o = offsets.data()](std::size_t i) { std::copy_n(s + i * block, c[i], v + o[i]); });
+    out = offsets[nb - 1] + counts[nb - 1];
+  }
+  return out;
+}
+
+} // namespace hpc
@@ -0,0 +1,173 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Set-membership predicate for large sets of integer keys: an open-addressing hash table built
+//! in parallel, optionally fronted by a blocked bloom filter.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+namespace hpc {
+
+// Hash table with linear probing over a power-of-two number of slots, at most half full.
+// Empty slots hold `empty`; whether `empty` itself belongs to the set is stored separately.
+//
+// The bloom filter uses one 64-bit word per key, in which 4 bits are set, so that a query loads a
+// single word. With 16 bits per key, it rejects about 99.8% of the keys that are not in the set.
+template <class T>
+class hash_set {
+  static_assert(std::is_integral_v<T>);
+
+ public:
+  static constexpr T empty = std::numeric_limits<T>::max();
+
+  hash_set(const std::vector<T>& keys, bool bloom = false) {
+    auto n = keys.size();
+    slots_.resize(std::bit_ceil(std::max<std::size_t>(2 * n, 2)));
+    std::fill(std::execution::par, slots_.begin(), slots_.end(), empty);
+    if (bloom) {
+      words_.resize(std::bit_ceil(std::max<std::size_t>(n / 4, 1)));
+      std::fill(std::execution::par, words_.begin(), words_.end(), 0);
+    }
+    has_empty_ = std::any_of(std::execution::par, keys.begin(), keys.end(),
+                             [](T x) { return x == empty; });
+
+    auto shift = 64 - std::countr_zero(slots_.size());
+    std::for_each(std::execution::par, keys.begin(), keys.end(),
+                  [=, s = slots_.data(), w = words_.data(), nw = words_.size(),
+                   mask = slots_.size() - 1, wmask = words_.size() - 1](T x) {
+                    if (x == empty) return;
+                    if (nw != 0) {
+                      auto h = bloom_hash(x);
+                      std::atomic_ref<std::uint64_t>(w[(h >> 32) & wmask])
+                          .fetch_or(bloom_bits(h), std::memory_order_relaxed);
+                    }
+                    for (auto i = slot(x, shift);; i = (i + 1) & mask) {
+                      T expected = empty;
+                      if (std::atomic_ref<T>(s[i]).compare_exchange_strong(
+                              expected, x, std::memory_order_relaxed) ||
+                          expected == x)
+                        return;
+                    }
+                  });
+  }
+
+  // Predicate testing membership in the set. It only refers to the storage of the set, so it is
+  // cheap to copy into the kernels of a select, and is only valid while the set is alive.
+  struct predicate {
+    const T* slots;
+    std::size_t mask;
+    int shift;
+    const std::uint64_t* words;
+    std::size_t nwords;
+    bool has_empty;
+
+    bool operator()(T x) const {
+      if (x == empty) return has_empty;
+      if (nwords != 0 && !maybe_contains(x)) return false;
+      return probe(x);
+    }
+
+    // Writes to `sel` the indices of the elements of `x[0, n)` that are in the set.
+    // The bloom filter is applied to the whole batch first, without branches so that it
+    // vectorizes, and only its survivors probe the table.
+    std::size_t filter(const T* x, std::size_t n, std::uint16_t* sel) const {
+      std::size_t k = 0;
+      if (nwords != 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+          sel[k] = (std::uint16_t)i;
+          k += maybe_contains(x[i]) | (x[i] == empty);
+        }
+      } else {
+        for (std::size_t i = 0; i < n; ++i) sel[i] = (std::uint16_t)i;
+        k = n;
+      }
+      std::size_t m = 0;
+      for (std::size_t q = 0; q < k; ++q) {
+        auto i = sel[q];
+        sel[m] = i;
+        m += x[i] == empty ? has_empty : probe(x[i]);
+      }
+      return m;
+    }
+
+    bool maybe_contains(T x) const {
+      auto h = bloom_hash(x);
+      auto bits = bloom_bits(h);
+      return (words[(h >> 32) & (nwords - 1)] & bits) == bits;
+    }
+
+    bool probe(T x) const {
+      for (auto i = slot(x, shift);; i = (i + 1) & mask) {
+        if (slots[i] == x) return true;
+        if (slots[i] == empty) return false;
+      }
+    }
+  };
+
+  predicate contains() const {
+    return {slots_.data(),
+            slots_.size() - 1,
+            64 - std::countr_zero(slots_.size()),
+            words_.data(),
+            words_.size(),
+            has_empty_};
+  }
+
+  // Bytes of the table and of the bloom filter.
+  std::size_t bytes() const {
+    return slots_.size() * sizeof(T) + words_.size() * sizeof(std::uint64_t);
+  }
+
+ private:
+  // Fibonacci hashing: the high bits of the product index the slots.
+  static std::size_t slot(T x, int shift) {
+    return (std::size_t)(((std::uint64_t)x * 0x9E3779B97F4A7C15ull) >> shift);
+  }
+  // Finalizer of MurmurHash3: the high half of the hash selects the word, and the low half the bits.
+  static std::uint64_t bloom_hash(T x) {
+    auto h = (std::uint64_t)x;
+    h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCDull;
+    h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 33);
+  }
+  // Four bit positions within the word.
+  static std::uint64_t bloom_bits(std::uint64_t h) {
+    return (1ull << (h & 63)) | (1ull << ((h >> 6) & 63)) | (1ull << ((h >> 12) & 63)) |
+           (1ull << ((h >> 18) & 63));
+  }
+
+  std::vector<T> slots_;
+  std::vector<std::uint64_t> words_;
+  bool has_empty_;
+};
+
+} // namespace hpc
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Parallel histogram, i.e., group-by count of integer keys in [0, nbins).
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <execution>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+namespace hpc {
+
+// Histogram with privatized bins: each chunk of `v` is counted into its own bins, which are then
+// summed bin by bin in parallel. `scratch` holds the private bins.
+//
+// Each chunk uses `lanes` interleaved sub-histograms, so that consecutive equal keys (frequent on
+// skewed inputs) increment different counters instead of waiting on each other's stores.
+template <class T>
+void histogram_private(const std::vector<T>& v, std::size_t nbins, std::vector<std::size_t>& bins,
+                       std::vector<std::uint32_t>& scratch) {
+  constexpr std::size_t lanes = 4;
+  auto n = v.size();
+  // 32-bit private counters can't overflow if each chunk has less than 2^32 elements:
+  auto nchunks = std::max<std::size_t>({1, std::thread::hardware_concurrency(), n >> 31});
+  auto chunk = (n + nchunks - 1) / nchunks;
+  scratch.resize(nchunks * lanes * nbins);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nchunks,
+                  [=, v = v.data(), s = scratch.data()](std::size_t c) {
+                    auto h = s + c * lanes * nbins;
+                    std::fill_n(h, lanes * nbins, 0);
+                    auto first = std::min(c * chunk, n), last = std::min(first + chunk, n);
+                    auto i = first;
+                    for (; i + lanes <= last; i += lanes) {
+                      for (std::size_t l = 0; l < lanes; ++l) {
+                        assert(v[i + l] >= 0 && (std::size_t)v[i + l] < nbins);
+                        ++h[l * nbins + v[i + l]];
+                      }
+                    }
+                    for (; i < last; ++i) ++h[v[i]];
+                  });
+  bins.resize(nbins);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nbins,
+                  [=, s = scratch.data(), b = bins.data()](std::size_t k) {
+                    std::size_t sum = 0;
+                    for (std::size_t h = 0; h < nchunks * lanes; ++h) sum += s[h * nbins + k];
+                    b[k] = sum;
+                  });
+}
+
+// Histogram with a single table of bins shared by all threads and updated atomically.
+template <class T>
+void histogram_atomic(const std::vector<T>& v, std::size_t nbins, std::vector<std::size_t>& bins) {
+  bins.resize(nbins);
+  std::fill(std::execution::par, bins.begin(), bins.end(), 0);
+  std::for_each(std::execution::par, v.begin(), v.end(), [nbins, b = bins.data()](T x) {
+    assert(x >= 0 && (std::size_t)x < nbins);
+    std::atomic_ref<std::size_t>(b[x]).fetch_add(1, std::memory_order_relaxed);
+  });
+}
+
+// Counts in `bins[k]` the number of elements of `v` equal to `k`, for `k` in [0, nbins).
+// Privatized bins are used while one set of them per thread fits in cache; for higher
+// cardinalities, merging them would cost more than contended atomics on a shared table.
+template <class T>
+void histogram(const std::vector<T>& v, std::size_t nbins, std::vector<std::size_t>& bins,
+               std::vector<std::uint32_t>& scratch, std::size_t max_private_bins = 1 << 14) {
+  if (nbins <= max_private_bins) {
+    histogram_private(v, nbins, bins, scratch);
+  } else {
+    histogram_atomic(v, nbins, bins);
+  }
+}
+
+} // namespace hpc
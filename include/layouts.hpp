@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! mdspan layout mappings for 2D grids: blocked (tiles contiguous) and Z-order (Morton).
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace hpc {
+
+// Blocked layout: the grid is split into tiles of BX x BY elements, which are stored one after the
+// other in row-major order of tiles, each tile in row-major order. The extents are rounded up to
+// whole tiles. Powers of two for BX and BY turn the index computation into shifts and masks.
+template <std::size_t BX, std::size_t BY>
+struct layout_blocked {
+  static constexpr std::size_t block_x = BX, block_y = BY;
+
+  template <class Extents>
+  class mapping {
+   public:
+    static_assert(Extents::rank() == 2, "layout_blocked is a layout of 2D grids");
+    using extents_type = Extents;
+    using index_type = typename Extents::index_type;
+    using size_type = typename Extents::size_type;
+    using rank_type = typename Extents::rank_type;
+    using layout_type = layout_blocked;
+
+    constexpr mapping() noexcept = default;
+    constexpr mapping(extents_type const& e) noexcept
+     : e_(e), tiles_y_((e.extent(1) + BY - 1) / BY) {}
+
+    constexpr extents_type const& extents() const noexcept { return e_; }
+
+    constexpr index_type required_span_size() const noexcept {
+      return (e_.extent(0) + BX - 1) / BX * BX * tiles_y_ * BY;
+    }
+
+    template <class I, class J>
+    constexpr index_type operator()(I i, J j) const noexcept {
+      auto x = static_cast<index_type>(i), y = static_cast<index_type>(j);
+      return ((x / BX) * tiles_y_ + y / BY) * (BX * BY) + (x % BX) * BY + y % BY;
+    }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return false; }
+    static constexpr bool is_always_strided() noexcept { return false; }
+    static constexpr bool is_unique() noexcept { return true; }
+    constexpr bool is_exhaustive() const noexcept {
+      return e_.extent(0) % BX == 0 && e_.extent(1) % BY == 0;
+    }
+    static constexpr bool is_strided() noexcept { return false; }
+
+    friend constexpr bool operator==(mapping const& a, mapping const& b) noexcept {
+      return a.extents() == b.extents();
+    }
+
+   private:
+    extents_type e_{};
+    index_type tiles_y_ = 0;
+  };
+};
+
+namespace detail {
+
+// Spreads the low 32 bits of `v` to the even bits of the result.
+constexpr std::uint64_t spread_bits(std::uint64_t v) noexcept {
+#if defined(__BMI2__)
+  if (!std::is_constant_evaluated()) return _pdep_u64(v, 0x5555555555555555ull);
+#endif
+  v &= 0xffffffffull;
+  v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+  v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+  v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+  v = (v | (v << 2)) & 0x3333333333333333ull;
+  v = (v | (v << 1)) & 0x5555555555555555ull;
+  return v;
+}
+
+// Number of bits needed to represent the indices [0, n).
+constexpr unsigned index_bits(std::uint64_t n) noexcept {
+  unsigned b = 0;
+  while ((std::uint64_t{1} << b) < n) ++b;
+  return b;
+}
+
+} // namespace detail
+
+// Z-order (Morton) layout: the offset of (i, j) interleaves the bits of i and j, so that every
+// aligned 2^k x 2^k square of the grid is contiguous, for all k. For rectangular grids, the bits of
+// the longer dimension that have no counterpart in the shorter one are stored above the
+// interleaved ones, i.e., the grid is a row (or column) of Morton-ordered squares. The extents are
+// rounded up to powers of two.
+struct layout_morton {
+  template <class Extents>
+  class mapping {
+   public:
+    static_assert(Extents::rank() == 2, "layout_morton is a layout of 2D grids");
+    using extents_type = Extents;
+    using index_type = typename Extents::index_type;
+    using size_type = typename Extents::size_type;
+    using rank_type = typename Extents::rank_type;
+    using layout_type = layout_morton;
+
+    constexpr mapping() noexcept = default;
+    constexpr mapping(extents_type const& e) noexcept
+     : e_(e), bits_x_(detail::index_bits(e.extent(0))), bits_y_(detail::index_bits(e.extent(1))),
+       bits_(bits_x_ < bits_y_ ? bits_x_ : bits_y_) {}
+
+    constexpr extents_type const& extents() const noexcept { return e_; }
+
+    constexpr index_type required_span_size() const noexcept {
+      return index_type{1} << (bits_x_ + bits_y_);
+    }
+
+    template <class I, class J>
+    constexpr index_type operator()(I i, J j) const noexcept {
+      auto x = static_cast<std::uint64_t>(i), y = static_cast<std::uint64_t>(j);
+      auto mask = (std::uint64_t{1} << bits_) - 1;
+      auto z = (detail::spread_bits(x & mask) << 1) | detail::spread_bits(y & mask);
+      // At most one of the two is non-zero:
+      return static_cast<index_type>(z | (((x >> bits_) | (y >> bits_)) << (2 * bits_)));
+    }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return false; }
+    static constexpr bool is_always_strided() noexcept { return false; }
+    static constexpr bool is_unique() noexcept { return true; }
+    constexpr bool is_exhaustive() const noexcept {
+      return required_span_size() == static_cast<index_type>(e_.extent(0) * e_.extent(1));
+    }
+    static constexpr bool is_strided() noexcept { return false; }
+
+    friend constexpr bool operator==(mapping const& a, mapping const& b) noexcept {
+      return a.extents() == b.extents();
+    }
+
+   private:
+    extents_type e_{};
+    unsigned bits_x_ = 0, bits_y_ = 0, bits_ = 0;
+  };
+};
+
+} // namespace hpc
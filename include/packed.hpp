@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Bit-packed integer column, and select kernels that unpack and filter it in a single pass.
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hpc {
+
+// Non-owning view of a `packed_column`. It holds the pointers to the arrays of the column, so that
+// the parallel kernels capture it by value instead of a pointer to the column, which may live on
+// the stack of the host thread.
+template <class T>
+struct packed_view {
+  static constexpr std::size_t block = 1024;
+
+  std::size_t n;
+  const T* refs;
+  const std::uint8_t* widths;
+  const std::size_t* offsets;
+  const std::uint64_t* words;
+
+  // Unpacks block `b` to `out`, and returns its number of values.
+  // The loop is instantiated for each bit width, so that the shifts and masks are constants and
+  // the compiler can unroll and vectorize it.
+  std::size_t unpack(std::size_t b, T* out) const {
+    auto m = std::min(n, (b + 1) * block) - b * block;
+    return [&]<std::size_t... W>(std::index_sequence<W...>) {
+      ((widths[b] == W ? unpack<W>(b, m, out) : void()), ...);
+      return m;
+    }(std::make_index_sequence<8 * sizeof(T) + 1>{});
+  }
+
+ private:
+  template <std::size_t W>
+  void unpack(std::size_t b, std::size_t m, T* out) const {
+    constexpr auto mask = (std::uint64_t{1} << W) - 1;
+    auto ref = refs[b];
+    auto in = words + offsets[b];
+    for (std::size_t j = 0; j < m; ++j) {
+      auto bit = j * W;
+      auto lo = in[bit / 64] >> (bit % 64);
+      auto hi = (in[bit / 64 + 1] << 1) << (63 - bit % 64);
+      out[j] = (T)((std::int64_t)ref + (std::int64_t)((lo | hi) & mask));
+    }
+  }
+};
+
+// Column of integers stored in blocks of `block` values. The values of a block are stored as
+// offsets from a reference value (the minimum of the block with frame-of-reference, or zero
+// otherwise), packed with the bit width of the largest offset. Each block starts on a 64-bit word.
+template <class T>
+class packed_column {
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 4);
+
+ public:
+  static constexpr std::size_t block = packed_view<T>::block;
+
+  packed_column(const std::vector<T>& v, bool frame_of_reference = true) : n_(v.size()) {
+    auto nblocks = (n_ + block - 1) / block;
+    refs_.resize(nblocks);
+    widths_.resize(nblocks);
+    offsets_.resize(nblocks + 1);
+    // Reference and bit width of each block, and its number of words:
+    std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                    [=, n = n_, v = v.data(), r = refs_.data(), w = widths_.data(),
+                     o = offsets_.data()](std::size_t b) {
+                      auto first = v + b * block, last = v + std::min(n, (b + 1) * block);
+                      auto [lo, hi] = std::minmax_element(first, last);
+                      auto ref = frame_of_reference ? *lo : std::min(*lo, T{0});
+                      r[b] = ref;
+                      w[b] = (std::uint8_t)std::bit_width((std::uint64_t)((std::int64_t)*hi - ref));
+                      o[b] = (w[b] * (std::size_t)(last - first) + 63) / 64;
+                    });
+    offsets_[nblocks] = 0;
+    std::exclusive_scan(offsets_.begin(), offsets_.end(), offsets_.begin(), std::size_t{0});
+    // Two words of padding, so that unpacking can always load the word after a value, even in an
+    // empty last block:
+    words_.resize(offsets_[nblocks] + 2);
+    std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                    [=, n = n_, v = v.data(), r = refs_.data(), w = widths_.data(),
+                     o = offsets_.data(), words = words_.data()](std::size_t b) {
+                      auto first = b * block, m = std::min(n, first + block) - first;
+                      // Pack to a local array, since the last word may spill into the next block:
+                      std::uint64_t out[block / 2 + 1] = {};
+                      for (std::size_t j = 0; j < m; ++j) {
+                        auto x = (std::uint64_t)((std::int64_t)v[first + j] - r[b]);
+                        auto bit = j * w[b];
+                        out[bit / 64] |= x << (bit % 64);
+                        // The high bits of a value that straddles two words (none if it doesn't):
+                        out[bit / 64 + 1] |= (x >> 1) >> (63 - bit % 64);
+                      }
+                      std::copy(out, out + (o[b + 1] - o[b]), words + o[b]);
+                    });
+  }
+
+  std::size_t size() const { return n_; }
+  std::size_t nblocks() const { return refs_.size(); }
+  // Bytes of packed data and of per-block metadata.
+  std::size_t bytes() const {
+    return words_.size() * sizeof(std::uint64_t) +
+           nblocks() * (sizeof(T) + sizeof(std::uint8_t) + sizeof(std::size_t));
+  }
+
+  // View of the column, valid while the column is alive and unchanged.
+  packed_view<T> view() const {
+    return {n_, refs_.data(), widths_.data(), offsets_.data(), words_.data()};
+  }
+
+  // Unpacks block `b` to `out`, and returns its number of values.
+  std::size_t unpack(std::size_t b, T* out) const { return view().unpack(b, out); }
+
+ private:
+  std::size_t n_;
+  std::vector<T> refs_;
+  std::vector<std::uint8_t> widths_;
+  std::vector<std::size_t> offsets_;
+  std::vector<std::uint64_t> words_;
+};
+
+namespace detail {
+// Unpacks block `b` of `c` to `x`, and writes to `rows` the indices in the block of the values that
+// satisfy `pred`. Returns their number.
+template <class T, class UnaryPredicate>
+std::size_t filter_packed_block(packed_view<T> c, const UnaryPredicate& pred,
+                                std::size_t b, T* x, std::uint16_t* rows) {
+  auto m = c.unpack(b, x);
+  std::size_t k = 0;
+  for (std::size_t j = 0; j < m; ++j) {
+    rows[k] = (std::uint16_t)j;
+    k += pred(x[j]);
+  }
+  return k;
+}
+
+// Counts the values of each block of `c` that satisfy `pred`, and stores in `counts` the exclusive
+// scan of the counts. Returns the total.
+template <class T, class UnaryPredicate>
+std::size_t count_packed(const packed_column<T>& c, UnaryPredicate pred,
+                         std::vector<std::size_t>& counts) {
+  constexpr auto block = packed_column<T>::block;
+  auto nblocks = c.nblocks();
+  counts.resize(nblocks + 1);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, c = c.view(), n = counts.data()](std::size_t b) {
+                    T x[block];
+                    auto m = c.unpack(b, x);
+                    std::size_t k = 0;
+                    for (std::size_t j = 0; j < m; ++j) k += pred(x[j]);
+                    n[b] = k;
+                  });
+  counts[nblocks] = 0;
+  std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), std::size_t{0});
+  return counts[nblocks];
+}
+
+// Calls `f(b, x, k, rows, offset)` for each block `b` of `c`, where `x` holds the values of the
+// block, `rows` the indices of the `k` values that satisfy `pred`, and `offset` the number of
+// values that satisfy `pred` in the previous blocks.
+template <class T, class UnaryPredicate, class F>
+void for_each_packed_block(const packed_column<T>& c, UnaryPredicate pred,
+                           const std::vector<std::size_t>& counts, F f) {
+  constexpr auto block = packed_column<T>::block;
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), c.nblocks(),
+                  [=, c = c.view(), n = counts.data()](std::size_t b) {
+                    T x[block];
+                    std::uint16_t rows[block];
+                    auto k = filter_packed_block(c, pred, b, x, rows);
+                    f(b, x, k, rows, n[b]);
+                  });
+}
+} // namespace detail
+
+// Select values from the packed column `c` using `pred` and copy them to `w`.
+// Each block is unpacked to a local array and filtered there, once to count the matches and once
+// to write them, so the unpacked column never goes through memory.
+template <class T, class UnaryPredicate>
+void select(const packed_column<T>& c, UnaryPredicate pred, std::vector<std::size_t>& counts,
+            std::vector<T>& w) {
+  w.resize(detail::count_packed(c, pred, counts));
+  detail::for_each_packed_block(
+      c, pred, counts,
+      [w = w.data()](std::size_t, const T* x, std::size_t k, const std::uint16_t* rows,
+                     std::size_t offset) {
+        for (std::size_t q = 0; q < k; ++q) w[offset + q] = x[rows[q]];
+      });
+}
+
+// Writes to `sel` the indices of the values of the packed column `c` that satisfy `pred`.
+template <class T, class UnaryPredicate, class Index>
+void select_rows(const packed_column<T>& c, UnaryPredicate pred, std::vector<std::size_t>& counts,
+                 std::vector<Index>& sel) {
+  constexpr auto block = packed_column<T>::block;
+  sel.resize(detail::count_packed(c, pred, counts));
+  detail::for_each_packed_block(
+      c, pred, counts,
+      [sel = sel.data()](std::size_t b, const T*, std::size_t k, const std::uint16_t* rows,
+                         std::size_t offset) {
+        for (std::size_t q = 0; q < k; ++q) sel[offset + q] = (Index)(b * block + rows[q]);
+      });
+}
+
+} // namespace hpc
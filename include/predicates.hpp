@@ -0,0 +1,216 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Predicate combinators that fuse several filters into a single pass over the data.
+//!
+//! `and_`, `or_` and `not_` compose predicates at compile time and evaluate all of them
+//! without short-circuiting, so that the compiler can vectorize the combined predicate.
+//! `reordered_and` instead measures the selectivity and cost of each predicate on a sample, and
+//! evaluates them one after another over blocks of surviving indices, cheapest-and-most-selective
+//! first.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace hpc {
+
+// Half-open range [lo, hi).
+template <class T>
+struct range {
+  T lo, hi;
+  constexpr bool operator()(T x) const { return (x >= lo) & (x < hi); }
+};
+template <class T>
+range(T, T) -> range<T>;
+
+// Membership in a small set of values, compared against all of them without branches.
+template <class T, std::size_t N>
+struct in_set {
+  std::array<T, N> values;
+  template <class... Ts>
+  constexpr in_set(T v, Ts... vs) : values{v, static_cast<T>(vs)...} {}
+  constexpr bool operator()(T x) const {
+    bool r = false;
+    for (auto v : values) r |= (x == v);
+    return r;
+  }
+};
+template <class T, class... Ts>
+in_set(T, Ts...) -> in_set<T, 1 + sizeof...(Ts)>;
+
+template <class P>
+struct not_ {
+  P p;
+  constexpr bool operator()(auto x) const { return !p(x); }
+};
+template <class P>
+not_(P) -> not_<P>;
+
+template <class... Ps>
+struct and_ {
+  std::tuple<Ps...> ps;
+  constexpr and_(Ps... ps) : ps{ps...} {}
+  constexpr bool operator()(auto x) const {
+    return std::apply([x](auto const&... p) { return (true & ... & p(x)); }, ps);
+  }
+};
+
+template <class... Ps>
+struct or_ {
+  std::tuple<Ps...> ps;
+  constexpr or_(Ps... ps) : ps{ps...} {}
+  constexpr bool operator()(auto x) const {
+    return std::apply([x](auto const&... p) { return (false | ... | p(x)); }, ps);
+  }
+};
+
+// Conjunction evaluated in an order chosen at run-time by `calibrate`.
+template <class... Ps>
+struct reordered_and {
+  static constexpr std::size_t size = sizeof...(Ps);
+  std::tuple<Ps...> ps;
+  std::array<std::size_t, size> order;
+
+  constexpr reordered_and(Ps... ps) : ps{ps...} {
+    std::iota(order.begin(), order.end(), 0);
+  }
+
+  bool operator()(auto x) const {
+    return std::apply([x](auto const&... p) { return (true & ... & p(x)); }, ps);
+  }
+
+  // Calls `f` with the `i`-th predicate.
+  template <class F>
+  std::size_t visit(std::size_t i, F&& f) const {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+      std::size_t r = 0;
+      ((i == I ? (r = f(std::get<I>(ps)), 0) : 0), ...);
+      return r;
+    }(std::index_sequence_for<Ps...>{});
+  }
+
+  // Sorts the predicates by increasing cost / (1 - selectivity) measured on `x[0, n)`, which
+  // minimizes the expected evaluation cost of a short-circuiting conjunction.
+  template <class T>
+  void calibrate(const T* x, std::size_t n) {
+    using clk_t = std::chrono::steady_clock;
+    std::array<double, size> rank;
+    for (std::size_t i = 0; i < size; ++i) {
+      auto start = clk_t::now();
+      auto count = visit(i, [=](auto const& p) {
+        std::size_t c = 0;
+        for (std::size_t j = 0; j < n; ++j) c += p(x[j]);
+        return c;
+      });
+      auto cost = std::chrono::duration<double>(clk_t::now() - start).count();
+      auto rejected = 1. - (double)count / (double)std::max(n, std::size_t{1});
+      rank[i] = cost / std::max(rejected, 1e-6);
+    }
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](auto a, auto b) { return rank[a] < rank[b]; });
+  }
+
+  // Writes to `sel` the indices of the elements of `x[0, n)` that satisfy all predicates,
+  // applying each predicate only to the survivors of the previous ones.
+  template <class T>
+  std::size_t filter(const T* x, std::size_t n, std::uint16_t* sel) const {
+    auto k = visit(order[0], [=](auto const& p) {
+      std::size_t k = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        sel[k] = (std::uint16_t)i;
+        k += p(x[i]);
+      }
+      return k;
+    });
+    for (std::size_t j = 1; j < size; ++j) {
+      k = visit(order[j], [=](auto const& p) {
+        std::size_t m = 0;
+        for (std::size_t q = 0; q < k; ++q) {
+          auto i = sel[q];
+          sel[m] = i;
+          m += p(x[i]);
+        }
+        return m;
+      });
+    }
+    return k;
+  }
+};
+
+// Writes to `sel` the indices of the elements of `x[0, n)` that satisfy `pred`.
+// The index is stored unconditionally and the output position only advances on a match, so the
+// loop has no data-dependent branches.
+template <class UnaryPredicate, class T>
+std::size_t filter_block(const UnaryPredicate& pred, const T* x, std::size_t n, std::uint16_t* sel) {
+  if constexpr (requires { pred.filter(x, n, sel); }) {
+    return pred.filter(x, n, sel);
+  } else {
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sel[k] = (std::uint16_t)i;
+      k += pred(x[i]);
+    }
+    return k;
+  }
+}
+
+// Select elements from "v" using "pred" and copy them to "w", one block at a time.
+// The first pass stores the indices of the matches of each block in its own slice of a heap
+// buffer, which kernels can access on the GPU, and counts them. The second pass copies the
+// matches to the offsets given by the exclusive scan of the counts.
+template <class T, class UnaryPredicate>
+void select_blocks(const std::vector<T>& v, const UnaryPredicate& pred,
+                   std::vector<std::size_t>& counts, std::vector<T>& w) {
+  constexpr std::size_t block = 4096;
+  auto n = v.size();
+  auto nblocks = (n + block - 1) / block;
+  counts.resize(nblocks + 1);
+  auto sel = std::unique_ptr<std::uint16_t[]>(new std::uint16_t[nblocks * block]);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, v = v.data(), c = counts.data(), sel = sel.get()](std::size_t b) {
+                    c[b] = filter_block(pred, v + b * block, std::min(block, n - b * block),
+                                        sel + b * block);
+                  });
+  counts[nblocks] = 0;
+  std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), std::size_t{0});
+  w.resize(counts[nblocks]);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, v = v.data(), c = counts.data(), w = w.data(),
+                   sel = sel.get()](std::size_t b) {
+                    auto x = v + b * block;
+                    auto s = sel + b * block;
+                    for (std::size_t i = 0; i < c[b + 1] - c[b]; ++i) w[c[b] + i] = x[s[i]];
+                  });
+}
+
+} // namespace hpc
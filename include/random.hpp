@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Counter-based random numbers (Philox4x32-10), for filling vectors in parallel.
+//!
+//! The `i`-th value only depends on the seed and on `i`, so the sequence is the same for any
+//! number of threads, and for the sequential and parallel versions of `generate`.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <execution>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+namespace hpc {
+
+// Philox4x32 with 10 rounds [Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11]:
+// returns 4 random 32-bit words for the 128-bit `counter` and the 64-bit `key`.
+constexpr std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> c,
+                                                  std::array<std::uint32_t, 2> k) {
+  for (int round = 0; round < 10; ++round) {
+    auto p0 = (std::uint64_t)0xD2511F53u * c[0];
+    auto p1 = (std::uint64_t)0xCD9E8D57u * c[2];
+    c = {(std::uint32_t)(p1 >> 32) ^ c[1] ^ k[0], (std::uint32_t)p1,
+         (std::uint32_t)(p0 >> 32) ^ c[3] ^ k[1], (std::uint32_t)p0};
+    k = {k[0] + 0x9E3779B9u, k[1] + 0xBB67AE85u};
+  }
+  return c;
+}
+
+// Returns the random words of the `i`-th value of the stream `seed`.
+constexpr std::array<std::uint32_t, 4> random_words(std::uint64_t seed, std::uint64_t i) {
+  return philox4x32({(std::uint32_t)i, (std::uint32_t)(i >> 32), 0, 0},
+                    {(std::uint32_t)seed, (std::uint32_t)(seed >> 32)});
+}
+
+// Integers uniformly distributed in the closed range [a, b], for types of at most 32 bits.
+// The range is scaled with a multiply-shift instead of rejection sampling, so that there are no
+// branches nor loops; the bias is below (b - a + 1) / 2^32.
+template <class T>
+struct uniform_int_distribution {
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 4);
+  T a, b;
+
+  constexpr T operator()(std::uint64_t seed, std::uint64_t i) const {
+    auto range = (std::uint64_t)((std::int64_t)b - (std::int64_t)a) + 1;
+    return (T)((std::int64_t)a + (std::int64_t)((random_words(seed, i)[0] * range) >> 32));
+  }
+};
+
+// Floating-point numbers uniformly distributed in the half-open range [a, b).
+template <class T>
+struct uniform_real_distribution {
+  static_assert(std::is_floating_point_v<T>);
+  T a, b;
+
+  constexpr T operator()(std::uint64_t seed, std::uint64_t i) const {
+    auto r = random_words(seed, i);
+    if constexpr (sizeof(T) <= 4) {
+      return a + (b - a) * ((T)(r[0] >> 8) * (T)0x1p-24);
+    } else {
+      auto bits = ((std::uint64_t)r[0] << 32 | r[1]) >> 11;
+      return a + (b - a) * ((T)bits * (T)0x1p-53);
+    }
+  }
+};
+
+// Fills `v` in parallel with `v[i] = distribution(seed, first + i)`. A sequence generated in
+// pieces, e.g., one chunk at a time, is the same as one generated at once if `first` is the index
+// of the first value of each piece.
+template <class T, class Distribution>
+void generate(std::vector<T>& v, Distribution distribution, std::uint64_t seed,
+              std::uint64_t first = 0) {
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), v.size(),
+                  [=, v = v.data()](std::size_t i) { v[i] = distribution(seed, first + i); });
+}
+
+} // namespace hpc
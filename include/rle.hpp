@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Parallel unique and run-length encoding.
+//!
+//! Element `i` starts a run if `i == 0` or `v[i] != v[i - 1]`. Every element is compared with its
+//! predecessor in `v` itself, not with the previous element of its block, so runs spanning block
+//! boundaries are handled without a fix-up pass.
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+namespace hpc {
+
+namespace detail {
+constexpr std::size_t run_block = 4096;
+
+template <class T>
+bool run_head(const T* v, std::size_t i) {
+  return i == 0 || !(v[i] == v[i - 1]);
+}
+
+// Calls `f(r, i)` for each element `i` of `v` that starts a run, where `r` is the index of that run.
+// `counts` holds the number of runs starting in each block. Returns the number of runs.
+template <class T, class F>
+std::size_t for_each_run(const std::vector<T>& v, std::vector<std::size_t>& counts, F f) {
+  auto n = v.size();
+  auto nblocks = (n + run_block - 1) / run_block;
+  counts.resize(nblocks + 1);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, v = v.data(), c = counts.data()](std::size_t b) {
+                    std::size_t k = 0;
+                    for (auto i = b * run_block; i < std::min(n, (b + 1) * run_block); ++i)
+                      k += run_head(v, i);
+                    c[b] = k;
+                  });
+  counts[nblocks] = 0;
+  std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), std::size_t{0});
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, v = v.data(), c = counts.data()](std::size_t b) {
+                    auto r = c[b];
+                    for (auto i = b * run_block; i < std::min(n, (b + 1) * run_block); ++i)
+                      if (run_head(v, i)) f(r++, i);
+                  });
+  return counts[nblocks];
+}
+} // namespace detail
+
+// Returns the number of runs of equal consecutive elements of `v`; for sorted `v`, the number of
+// distinct elements.
+template <class T>
+std::size_t unique_count(const std::vector<T>& v) {
+  auto ids = std::views::iota(std::size_t{0}, v.size());
+  return std::transform_reduce(std::execution::par, ids.begin(), ids.end(), std::size_t{0},
+                               std::plus<>{}, [v = v.data()](std::size_t i) -> std::size_t {
+                                 return detail::run_head(v, i);
+                               });
+}
+
+// Copies to `w` the first element of each run of equal consecutive elements of `v`.
+// `counts` holds the number of runs of each block.
+template <class T>
+void unique(const std::vector<T>& v, std::vector<T>& w, std::vector<std::size_t>& counts) {
+  w.resize(unique_count(v));
+  detail::for_each_run(v, counts, [v = v.data(), w = w.data()](std::size_t r, std::size_t i) {
+    w[r] = v[i];
+  });
+}
+
+// Run-length encodes `v`: run `r` has `lengths[r]` elements equal to `values[r]`.
+// `starts` holds the position of the first element of each run.
+template <class T, class Length>
+void rle_encode(const std::vector<T>& v, std::vector<T>& values, std::vector<Length>& lengths,
+                std::vector<std::size_t>& starts, std::vector<std::size_t>& counts) {
+  auto m = unique_count(v);
+  values.resize(m);
+  lengths.resize(m);
+  starts.resize(m + 1);
+  detail::for_each_run(v, counts,
+                       [v = v.data(), w = values.data(), s = starts.data()](std::size_t r,
+                                                                            std::size_t i) {
+                         w[r] = v[i];
+                         s[r] = i;
+                       });
+  starts[m] = v.size();
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), m,
+                  [s = starts.data(), l = lengths.data()](std::size_t r) {
+                    l[r] = (Length)(s[r + 1] - s[r]);
+                  });
+}
+
+// Decodes the runs of `values` and `lengths` into `v`. `offsets` holds the position of the first
+// element of each run. The output is split into equal blocks, each of which looks up its first run
+// with a binary search, so that long runs are spread over several threads.
+template <class T, class Length>
+void rle_decode(const std::vector<T>& values, const std::vector<Length>& lengths,
+                std::vector<T>& v, std::vector<std::size_t>& offsets) {
+  auto m = values.size();
+  offsets.resize(m + 1);
+  std::transform_exclusive_scan(lengths.begin(), lengths.end(), offsets.begin(), std::size_t{0},
+                                std::plus<>{}, [](Length l) { return (std::size_t)l; });
+  auto n = m == 0 ? std::size_t{0} : offsets[m - 1] + (std::size_t)lengths[m - 1];
+  offsets[m] = n;
+  v.resize(n);
+  auto nblocks = (n + detail::run_block - 1) / detail::run_block;
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, w = values.data(), o = offsets.data(), v = v.data()](std::size_t b) {
+                    auto first = b * detail::run_block;
+                    auto last = std::min(n, first + detail::run_block);
+                    auto r = std::upper_bound(o, o + m, first) - o - 1;
+                    for (auto i = first; i < last; ++r) {
+                      auto end = std::min(last, o[r + 1]);
+                      std::fill(v + i, v + end, w[r]);
+                      i = end;
+                    }
+                  });
+}
+
+} // namespace hpc
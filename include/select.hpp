@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Select engines from the select lab solutions, so that they can be compared with each other.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <vector>
+#include <workspace.hpp>
+
+namespace hpc {
+
+// Select with parallel `count_if` + `copy_if` (Exercise 1).
+template <class T, class UnaryPredicate>
+void select_copy_if(const std::vector<T>& v, UnaryPredicate pred, std::vector<T>& w) {
+  w.resize(std::count_if(std::execution::par, v.begin(), v.end(), pred));
+  std::copy_if(std::execution::par, v.begin(), v.end(), w.begin(), pred);
+}
+
+// Select with parallel `transform_inclusive_scan` + `for_each` (Exercise 2), storing the output
+// position of each element in `index`.
+template <class T, class Index, class UnaryPredicate>
+void select_scan(const std::vector<T>& v, UnaryPredicate pred, std::vector<Index>& index,
+                 std::vector<T>& w) {
+  index.resize(v.size());
+  std::transform_inclusive_scan(std::execution::par, v.begin(), v.end(), index.begin(),
+                                std::plus<Index>{},
+                                [pred](T const& x) { return pred(x) ? Index{1} : Index{0}; });
+  w.resize(index.empty() ? 0 : index.back());
+  std::for_each_n(std::execution::par, std::views::iota(Index{0}).begin(), (Index)v.size(),
+                  [pred, v = v.data(), w = w.data(), index = index.data()](Index i) {
+                    if (pred(v[i])) w[index[i] - 1] = v[i];
+                  });
+}
+
+// Scan-based select with 32-bit indices whenever they can represent `v.size()`, which halves
+// the memory traffic of the scan. `index` is only used when 64-bit indices are needed.
+template <class T, class UnaryPredicate>
+void select_scan(const std::vector<T>& v, UnaryPredicate pred, std::vector<std::uint32_t>& index32,
+                 std::vector<std::size_t>& index, std::vector<T>& w) {
+  if (v.size() <= std::numeric_limits<std::uint32_t>::max()) {
+    select_scan(v, pred, index32, w);
+  } else {
+    select_scan(v, pred, index, w);
+  }
+}
+
+// Select with parallel `count_if` + `copy_if` into an array of `ws`. Returns the selected elements,
+// which are valid until the next `ws.reset()`.
+template <class T, class UnaryPredicate>
+std::span<T> select_copy_if(const std::vector<T>& v, UnaryPredicate pred, workspace& ws) {
+  auto w = ws.get<T>(std::count_if(std::execution::par, v.begin(), v.end(), pred));
+  std::copy_if(std::execution::par, v.begin(), v.end(), w.begin(), pred);
+  return w;
+}
+
+// Scan-based select with the indices and the output in arrays of `ws`, with 32-bit indices
+// whenever they can represent `v.size()`. Returns the selected elements, which are valid until the
+// next `ws.reset()`.
+template <class T, class UnaryPredicate>
+std::span<T> select_scan(const std::vector<T>& v, UnaryPredicate pred, workspace& ws) {
+  auto run = [&]<class Index>(Index) {
+    auto index = ws.get<Index>(v.size());
+    std::transform_inclusive_scan(std::execution::par, v.begin(), v.end(), index.begin(),
+                                  std::plus<Index>{},
+                                  [pred](T const& x) { return pred(x) ? Index{1} : Index{0}; });
+    auto w = ws.get<T>(index.empty() ? 0 : index.back());
+    std::for_each_n(std::execution::par, std::views::iota(Index{0}).begin(), (Index)v.size(),
+                    [pred, v = v.data(), w = w.data(), index = index.data()](Index i) {
+                      if (pred(v[i])) w[index[i] - 1] = v[i];
+                    });
+    return w;
+  };
+  if (v.size() <= std::numeric_limits<std::uint32_t>::max()) {
+    return run(std::uint32_t{});
+  } else {
+    return run(std::size_t{});
+  }
+}
+
+// Unordered select: the matches of each block of `v` are counted, an offset in `w` is reserved
+// for them with one atomic `fetch_add` per block, and the block is filtered again straight to `w`
+// (the second pass reads the block from cache). There is no scan over the counts, but the order of
+// the blocks in `w` is unspecified. Returns the selected elements, which are valid until the next
+// `ws.reset()`.
+template <class T, class UnaryPredicate>
+std::span<T> select_unordered(const std::vector<T>& v, UnaryPredicate pred, workspace& ws) {
+  constexpr std::size_t block = 4096;
+  auto n = v.size();
+  auto w = ws.get<T>(n);
+  auto count = ws.get<std::size_t>(1);
+  count[0] = 0;
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(),
+                  (n + block - 1) / block,
+                  [=, v = v.data(), w = w.data(), count = count.data()](std::size_t b) {
+                    auto first = b * block, last = std::min(n, first + block);
+                    std::size_t k = 0;
+                    for (auto i = first; i < last; ++i) k += pred(v[i]);
+                    auto offset = std::atomic_ref<std::size_t>(*count).fetch_add(
+                        k, std::memory_order_relaxed);
+                    // The writes are conditional: past the last match, `w[offset]` belongs to
+                    // another block.
+                    for (auto i = first; i < last; ++i) {
+                      if (pred(v[i])) w[offset++] = v[i];
+                    }
+                  });
+  return w.first(count[0]);
+}
+
+// Struct-of-arrays select: selects the rows `i` for which `pred(keys[i]...)` holds, and copies
+// them from each of `columns` to the corresponding vector of `out`.
+// The predicate is evaluated once per row: the first pass stores the indices of the selected rows
+// of each block in its own slice of a heap buffer and counts them, and the second pass uses the
+// offsets given by the exclusive scan of the counts to gather all columns.
+template <class... Ks, class Pred, class... Cs>
+void select_columns(std::tuple<std::span<const Ks>...> keys, Pred pred,
+                    std::tuple<std::span<const Cs>...> columns, std::tuple<std::vector<Cs>&...> out,
+                    std::vector<std::size_t>& counts) {
+  constexpr std::size_t block = 4096;
+  auto n = std::get<0>(keys).size();
+  auto nblocks = (n + block - 1) / block;
+  counts.resize(nblocks + 1);
+  auto sel = std::unique_ptr<std::uint16_t[]>(new std::uint16_t[nblocks * block]);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, c = counts.data(), sel = sel.get()](std::size_t b) {
+                    auto first = b * block, last = std::min(first + block, n);
+                    auto s = sel + first;
+                    std::size_t k = 0;
+                    for (auto i = first; i < last; ++i) {
+                      s[k] = (std::uint16_t)(i - first);
+                      k += std::apply([i, pred](auto... key) { return pred(key[i]...); }, keys);
+                    }
+                    c[b] = k;
+                  });
+  counts[nblocks] = 0;
+  std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), std::size_t{0});
+  std::apply([&](auto&... o) { (o.resize(counts[nblocks]), ...); }, out);
+  auto outs = std::apply([](auto&... o) { return std::tuple{o.data()...}; }, out);
+  std::for_each_n(std::execution::par, std::views::iota(std::size_t{0}).begin(), nblocks,
+                  [=, c = counts.data(), sel = sel.get()](std::size_t b) {
+                    auto s = sel + b * block;
+                    auto k = c[b + 1] - c[b];
+                    [&]<std::size_t... I>(std::index_sequence<I...>) {
+                      (std::transform(s, s + k, std::get<I>(outs) + c[b],
+                                      [in = std::get<I>(columns).data() + b * block](auto j) {
+                                        return in[j];
+                                      }),
+                       ...);
+                    }(std::index_sequence_for<Cs...>{});
+                  });
+}
+
+} // namespace hpc
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Compile-time stencil descriptors and fully unrolled stencil kernels.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace hpc {
+
+// One point of a stencil: its offset from the updated cell along each dimension, and its weight.
+template <std::size_t Rank>
+struct stencil_point {
+  std::array<long, Rank> offset;
+  double weight;
+};
+
+// A stencil descriptor is a type with a `static constexpr std::array<stencil_point<Rank>, N>
+// points` member, which discretizes an operator L as: (L u)(i) = sum_k w_k * u(i + offset_k).
+// Any list of offsets and weights works, e.g., anisotropic weights or diagonal neighbors; the
+// halo width and the rank are deduced from it.
+
+// 2nd-order 5-point Laplacian.
+struct five_point {
+  static constexpr std::array<stencil_point<2>, 5> points{{
+    {{0, 0}, -4.},
+    {{-1, 0}, 1.}, {{1, 0}, 1.},
+    {{0, -1}, 1.}, {{0, 1}, 1.},
+  }};
+};
+
+// 4th-order 9-point Laplacian (cross of radius 2).
+struct nine_point {
+  static constexpr std::array<stencil_point<2>, 9> points{{
+    {{0, 0}, -5.},
+    {{-1, 0}, 4. / 3.}, {{1, 0}, 4. / 3.}, {{0, -1}, 4. / 3.}, {{0, 1}, 4. / 3.},
+    {{-2, 0}, -1. / 12.}, {{2, 0}, -1. / 12.}, {{0, -2}, -1. / 12.}, {{0, 2}, -1. / 12.},
+  }};
+};
+
+// 6th-order 13-point Laplacian (cross of radius 3).
+struct thirteen_point {
+  static constexpr std::array<stencil_point<2>, 13> points{{
+    {{0, 0}, -49. / 9.},
+    {{-1, 0}, 3. / 2.}, {{1, 0}, 3. / 2.}, {{0, -1}, 3. / 2.}, {{0, 1}, 3. / 2.},
+    {{-2, 0}, -3. / 20.}, {{2, 0}, -3. / 20.}, {{0, -2}, -3. / 20.}, {{0, 2}, -3. / 20.},
+    {{-3, 0}, 1. / 90.}, {{3, 0}, 1. / 90.}, {{0, -3}, 1. / 90.}, {{0, 3}, 1. / 90.},
+  }};
+};
+
+// Number of dimensions of the stencil `S`.
+template <class S>
+constexpr std::size_t stencil_rank = S::points[0].offset.size();
+
+// Halo width of the stencil `S`: the largest offset along any dimension.
+template <class S>
+constexpr long halo_width() {
+  long h = 0;
+  for (auto const& p : S::points) {
+    for (auto o : p.offset) h = std::max(h, o < 0 ? -o : o);
+  }
+  return h;
+}
+
+// Sum of the absolute weights of the stencil `S`. It bounds the spectral radius of the operator,
+// so that the explicit Euler update u + gamma * L u is stable for gamma * stencil_norm <= 2.
+template <class S>
+constexpr double stencil_norm() {
+  double n = 0.;
+  for (auto const& p : S::points) n += p.weight < 0. ? -p.weight : p.weight;
+  return n;
+}
+
+namespace detail {
+
+// Returns u(i + offset), for the `K`-th point of the stencil `S`.
+template <class S, std::size_t K, class Grid, class... Index>
+constexpr auto neighbor(Grid u, Index... i) {
+  return [&]<std::size_t... D>(std::index_sequence<D...>) {
+    return u((i + S::points[K].offset[D])...);
+  }(std::index_sequence_for<Index...>{});
+}
+
+} // namespace detail
+
+// Returns sum_k w_k * u(i + offset_k) for the stencil `S`, as one expression unrolled at compile
+// time. The points are summed in the order of the descriptor.
+template <class S, class Grid, class... Index>
+constexpr auto stencil_sum(Grid u, Index... i) {
+  static_assert(sizeof...(Index) == stencil_rank<S>, "one index per dimension of the stencil");
+  return [&]<std::size_t... K>(std::index_sequence<K...>) {
+    return (... + (S::points[K].weight * detail::neighbor<S, K>(u, i...)));
+  }(std::make_index_sequence<S::points.size()>{});
+}
+
+} // namespace hpc
@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Parallel top-k and k-th largest element.
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <vector>
+#include <select.hpp>
+
+namespace hpc {
+
+// Writes to `out` a superset of the `k` largest elements of `v`, using per-chunk heaps:
+// each chunk keeps its `k` largest elements in a min-heap, and the heaps are concatenated.
+template <class T>
+void top_k_candidates_heaps(const std::vector<T>& v, std::size_t k, std::vector<T>& out) {
+  auto n = v.size();
+  auto nchunks = std::max(1u, std::thread::hardware_concurrency());
+  auto chunk = (n + nchunks - 1) / nchunks;
+  out.resize(nchunks * k);
+  std::vector<std::size_t> sizes(nchunks);
+  std::for_each_n(std::execution::par, std::views::iota(0u).begin(), nchunks,
+                  [=, v = v.data(), o = out.data(), s = sizes.data()](unsigned c) {
+                    auto first = std::min(c * chunk, n), last = std::min(first + chunk, n);
+                    auto heap = o + c * k;
+                    std::size_t m = 0;
+                    for (auto i = first; i < last; ++i) {
+                      if (m < k) {
+                        heap[m++] = v[i];
+                        std::push_heap(heap, heap + m, std::greater<>{});
+                      } else if (v[i] > heap[0]) {
+                        std::pop_heap(heap, heap + m, std::greater<>{});
+                        heap[m - 1] = v[i];
+                        std::push_heap(heap, heap + m, std::greater<>{});
+                      }
+                    }
+                    s[c] = m;
+                  });
+  // Compact the partially filled heaps:
+  std::size_t m = 0;
+  for (unsigned c = 0; c < nchunks; ++c) {
+    std::copy_n(out.begin() + c * k, sizes[c], out.begin() + m);
+    m += sizes[c];
+  }
+  out.resize(m);
+}
+
+// Writes to `out` a superset of the `k` largest elements of `v`, using sampling and a select:
+// the threshold is estimated from the order statistics of a random sample of `v`, and the
+// elements above it are selected with one parallel pass. If less than `k` elements are selected,
+// the threshold is lowered and the select repeated.
+template <class T>
+void top_k_candidates_sample(const std::vector<T>& v, std::size_t k, std::vector<T>& out,
+                             std::size_t nsample = std::size_t{1} << 16) {
+  auto n = v.size();
+  nsample = std::min(nsample, n);
+  std::vector<T> sample(nsample);
+  auto engine = std::mt19937_64{1};
+  auto distribution = std::uniform_int_distribution<std::size_t>{0, n - 1};
+  std::generate(sample.begin(), sample.end(), [&] { return v[distribution(engine)]; });
+  std::sort(sample.begin(), sample.end(), std::greater<>{});
+
+  // Expected rank of the k-th largest element in the sample, plus 3 standard deviations:
+  auto r = (double)k * (double)nsample / (double)n;
+  auto rank = (std::size_t)(r + 3. * std::sqrt(r) + 1.);
+  while (true) {
+    if (rank >= nsample) {
+      out = v;
+      return;
+    }
+    hpc::select_copy_if(v, [t = sample[rank]](T const& x) { return x >= t; }, out);
+    if (out.size() >= k) return;
+    rank *= 2;
+  }
+}
+
+// Writes to `out` a superset of the `k` largest elements of `v`.
+// Per-chunk heaps are used for small `k`, and sampling + select otherwise.
+template <class T>
+void top_k_candidates(const std::vector<T>& v, std::size_t k, std::vector<T>& out) {
+  if (k <= 1024) {
+    top_k_candidates_heaps(v, k, out);
+  } else {
+    top_k_candidates_sample(v, k, out);
+  }
+}
+
+// Writes to `out` the `k` largest elements of `v` in decreasing order.
+template <class T>
+void top_k(const std::vector<T>& v, std::size_t k, std::vector<T>& out) {
+  k = std::min(k, v.size());
+  if (k == 0) {
+    out.clear();
+    return;
+  }
+  top_k_candidates(v, k, out);
+  std::nth_element(std::execution::par, out.begin(), out.begin() + k, out.end(), std::greater<>{});
+  out.resize(k);
+  std::sort(std::execution::par, out.begin(), out.end(), std::greater<>{});
+}
+
+// Returns the `k`-th largest element of `v`, for `k` in [1, v.size()]. `scratch` holds the
+// candidates.
+template <class T>
+T kth_largest(const std::vector<T>& v, std::size_t k, std::vector<T>& scratch) {
+  top_k_candidates(v, k, scratch);
+  std::nth_element(std::execution::par, scratch.begin(), scratch.begin() + (k - 1), scratch.end(),
+                   std::greater<>{});
+  return scratch[k - 1];
+}
+
+} // namespace hpc
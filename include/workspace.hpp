@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+//! Reusable scratch memory for kernels that are called repeatedly, e.g., once per batch.
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace hpc {
+
+// Bump allocator over a single buffer that is kept across calls.
+//
+// `get` hands out uninitialized, cache-line aligned arrays, which stay valid until the next
+// `reset`. Requests that do not fit in the buffer are served from separate allocations, and the
+// next `reset` grows the buffer to the high-water mark, so that after the first calls a kernel
+// runs without allocating. The memory is never value-initialized: it is touched (and page
+// faulted) only when the kernels write it.
+class workspace {
+ public:
+  static constexpr std::size_t alignment = 64;
+
+  workspace() = default;
+  explicit workspace(std::size_t bytes) : buffer_(allocate(bytes)), capacity_(bytes) {}
+
+  // Returns an uninitialized array of `n` elements of type `T`.
+  template <class T>
+  std::span<T> get(std::size_t n) {
+    static_assert(std::is_trivially_default_constructible_v<T> &&
+                  std::is_trivially_destructible_v<T>);
+    static_assert(alignof(T) <= alignment);
+    auto bytes = n * sizeof(T);
+    // The buffer is aligned, so aligning the offset aligns the array. The offset is checked against
+    // the capacity before forming a pointer from it, since `used_` exceeds the capacity once the
+    // buffer is exhausted:
+    auto offset = (used_ + alignment - 1) / alignment * alignment;
+    if (offset <= capacity_ && bytes <= capacity_ - offset) {
+      used_ = offset + bytes;
+      high_water_ = std::max(high_water_, used_);
+      return {reinterpret_cast<T*>(buffer_.get() + offset), n};
+    }
+    // Account for the worst-case padding, so that the grown buffer fits the same requests:
+    used_ += alignment + bytes;
+    high_water_ = std::max(high_water_, used_);
+    overflow_.emplace_back(allocate(bytes));
+    ++allocations_;
+    return {reinterpret_cast<T*>(overflow_.back().get()), n};
+  }
+
+  // Releases all arrays returned by `get`.
+  void reset() {
+    if (!overflow_.empty()) {
+      overflow_.clear();
+      buffer_.reset(allocate(high_water_));
+      capacity_ = high_water_;
+      ++allocations_;
+    }
+    used_ = 0;
+  }
+
+  // Largest number of bytes in use between two resets, including alignment padding.
+  std::size_t high_water() const { return high_water_; }
+  std::size_t capacity() const { return capacity_; }
+  // Number of allocations made since construction.
+  std::size_t allocations() const { return allocations_; }
+
+ private:
+  // Frees the memory of `allocate`.
+  struct deleter {
+    void operator()(std::byte* p) const { ::operator delete(p, std::align_val_t{alignment}); }
+  };
+  using buffer_t = std::unique_ptr<std::byte, deleter>;
+
+  // Returns `bytes` uninitialized bytes aligned to `alignment`.
+  static std::byte* allocate(std::size_t bytes) {
+    return static_cast<std::byte*>(::operator new(bytes, std::align_val_t{alignment}));
+  }
+
+  buffer_t buffer_;
+  std::size_t capacity_ = 0, used_ = 0, high_water_ = 0, allocations_ = 0;
+  std::vector<buffer_t> overflow_;
+};
+
+} // namespace hpc
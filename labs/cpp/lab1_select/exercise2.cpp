@@ -27,9 +27,9 @@
 #include <vector>
 #include <iterator>
 #include <iostream>
-#include <random>
 #include <ranges>
 #include <execution>
+#include <random.hpp>
 
 // Select elements and copy them to a new vector
 template <class UnaryPredicate>
@@ -94,9 +94,7 @@ int main(int argc, char* argv[])
 
 void initialize(std::vector<int>& v)
 {
-    auto distribution = std::uniform_int_distribution<int> {0, 100};
-    auto engine = std::mt19937 {1};
-    std::generate(v.begin(), v.end(), [&distribution, &engine]{ return distribution(engine); });
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
 }
 
 template <typename Predicate>
@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Late materialization: filters produce bitmaps, values are gathered once at the end.
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <vector>
+#include <bitmap.hpp>
+#include <random.hpp>
+
+// Select elements from "v" using "pred" and copy them to "w".
+template <class UnaryPredicate>
+void select(const std::vector<int>& v, UnaryPredicate pred, std::vector<int>& w)
+{
+    w.resize(std::count_if(std::execution::par, v.begin(), v.end(), pred));
+    std::copy_if(std::execution::par, v.begin(), v.end(), w.begin(), pred);
+}
+
+// Applies both predicates by materializing the output of the first one.
+template <class P0, class P1>
+void select_materialize(const std::vector<int>& v, P0 p0, P1 p1, std::vector<int>& tmp, std::vector<int>& w)
+{
+    select(v, p0, tmp);
+    select(tmp, p1, w);
+}
+
+// Applies both predicates into bitmaps, combines them, and gathers the selected values once.
+template <class P0, class P1>
+void select_late(const std::vector<int>& v, P0 p0, P1 p1, hpc::bitmap& b0, hpc::bitmap& b1,
+                 std::vector<std::size_t>& offsets, std::vector<int>& w)
+{
+    hpc::select_bitmap(v, p0, b0);
+    hpc::select_bitmap(v, p1, b1);
+    hpc::bitmap_and(b0, b1, b0);
+    hpc::word_offsets(b0, offsets);
+    hpc::gather(v, b0, offsets, w);
+}
+
+// Initialize vector
+void initialize(std::vector<int>& v);
+
+// Benchmarks the implementation
+template <typename F>
+double bench(F&& f);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    // Allocate the data vector, and a payload column containing the row number
+    auto v = std::vector<int>(n);
+    auto rows = std::vector<int>(n);
+    initialize(v);
+    std::iota(rows.begin(), rows.end(), 0);
+
+    auto p0 = [](int x) { return x % 3 == 0; };
+    auto p1 = [](int x) { return x < 50; };
+    auto both = [p0, p1](int x) { return p0(x) && p1(x); };
+
+    std::vector<int> tmp, w_mat, w, w_rows;
+    hpc::bitmap b0, b1;
+    std::vector<std::size_t> offsets;
+    std::vector<std::uint32_t> sel;
+    select_materialize(v, p0, p1, tmp, w_mat);
+    select_late(v, p0, p1, b0, b1, offsets, w);
+
+    // Gather a second column with the same bitmap, and also through a selection vector:
+    hpc::gather(rows, b0, offsets, w_rows);
+    hpc::to_selection_vector(b0, offsets, sel);
+    std::vector<int> w_sel;
+    hpc::gather(v, sel, w_sel);
+
+    bool ok = !w.empty() && w == w_mat && w == w_sel && w_rows.size() == w.size()
+        && std::all_of(w.begin(), w.end(), both)
+        && (long long)w.size() == std::count_if(v.begin(), v.end(), both);
+    for (std::size_t i = 0; ok && i < w.size(); ++i) ok = v[w_rows[i]] == w[i];
+    if (!ok) {
+        std::cerr << "ERROR! ";
+        std::cout << "w[0.." << std::min(10, (int)w.size()) << "] = ";
+        std::copy(w.begin(), w.begin() + std::min(10, (int)w.size()), std::ostream_iterator<int>(std::cout, " "));
+        std::cout << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    // Bytes written between the two filters:
+    auto mat_gb = (double)tmp.size() * sizeof(int) * 1.e-9;
+    auto late_gb = 2. * (double)b0.words.size() * sizeof(std::uint64_t) * 1.e-9;
+    auto seconds_mat = bench([&] { select_materialize(v, p0, p1, tmp, w_mat); });
+    auto seconds_late = bench([&] { select_late(v, p0, p1, b0, b1, offsets, w); });
+    std::cerr << "Materialize: " << seconds_mat << " s, intermediate " << mat_gb << " GB" << std::endl;
+    std::cerr << "Bitmap:      " << seconds_late << " s, intermediate " << late_gb << " GB" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
+}
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
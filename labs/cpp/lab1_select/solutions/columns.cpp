@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Multi-column select: a predicate on a key column selects the rows of 1 to 16 payload columns
+//! of mixed types, either with one scan-based select per column or in a single pass.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <vector>
+#include <select.hpp>
+#include <random.hpp>
+
+// Payload column types, cycled through by the payload columns:
+using column_types = std::tuple<int, double, float, std::int64_t>;
+template <std::size_t I>
+using column_t = std::tuple_element_t<I % std::tuple_size_v<column_types>, column_types>;
+
+// Select elements from "column" at the rows where "pred(key)" holds, using a scan over "key".
+template <class T, class UnaryPredicate>
+void select_column(const std::vector<int>& key, UnaryPredicate pred, const std::vector<T>& column,
+                   std::vector<std::uint32_t>& index, std::vector<T>& w)
+{
+    index.resize(key.size());
+    std::transform_inclusive_scan(std::execution::par, key.begin(), key.end(), index.begin(), std::plus<std::uint32_t>{},
+                                  [pred](int x) { return pred(x) ? 1u : 0u; });
+    w.resize(index.empty() ? 0 : index.back());
+    std::for_each_n(std::execution::par, std::views::iota(std::uint32_t{0}).begin(), (std::uint32_t)key.size(),
+        [pred, key = key.data(), c = column.data(), w = w.data(), index = index.data()](std::uint32_t i) {
+            if (pred(key[i])) w[index[i] - 1] = c[i];
+    });
+}
+
+// Initialize vector
+void initialize(std::vector<int>& v);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+// Selects the first "N" columns of "columns" one column at a time into "per_column", and all at
+// once into "fused". Returns the two selects, to be called once or benchmarked.
+template <std::size_t N, class Columns, class UnaryPredicate, class Outputs>
+auto select_both(const std::vector<int>& key, UnaryPredicate pred, const Columns& columns,
+                 Outputs& per_column, Outputs& fused, std::vector<std::uint32_t>& index,
+                 std::vector<std::size_t>& counts)
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        auto run_per_column = [&, pred] {
+            (select_column(key, pred, std::get<I>(columns), index, std::get<I>(per_column)), ...);
+        };
+        auto run_fused = [&, pred] {
+            hpc::select_columns(std::tuple{std::span<const int>{key}}, pred,
+                                std::tuple{std::span<const column_t<I>>{std::get<I>(columns)}...},
+                                std::tie(std::get<I>(fused)...), counts);
+        };
+        return std::pair{run_per_column, run_fused};
+    }(std::make_index_sequence<N>{});
+}
+
+// Checks that the per-column and fused selects of the first "N" columns of "columns" agree.
+template <std::size_t N, class Columns, class UnaryPredicate>
+bool check_columns(const std::vector<int>& key, UnaryPredicate pred, const Columns& columns)
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        std::tuple<std::vector<column_t<I>>...> per_column, fused;
+        std::vector<std::uint32_t> index;
+        std::vector<std::size_t> counts;
+        auto [run_per_column, run_fused] = select_both<N>(key, pred, columns, per_column, fused, index, counts);
+        run_per_column();
+        run_fused();
+        return per_column == fused;
+    }(std::make_index_sequence<N>{});
+}
+
+// Benchmarks the per-column and fused selects of the first "N" columns of "columns".
+template <std::size_t N, class Columns, class UnaryPredicate>
+void bench_columns(const std::vector<int>& key, UnaryPredicate pred, const Columns& columns)
+{
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        std::tuple<std::vector<column_t<I>>...> per_column, fused;
+        std::vector<std::uint32_t> index;
+        std::vector<std::size_t> counts;
+        auto [run_per_column, run_fused] = select_both<N>(key, pred, columns, per_column, fused, index, counts);
+        auto seconds_per_column = bench(run_per_column);
+        auto seconds_fused = bench(run_fused);
+
+        // Bytes read from the key and payload columns, plus bytes written to the selected payload rows:
+        auto k = (double)std::get<0>(fused).size();
+        auto gigabytes = (sizeof(int) * (double)key.size() + (... + (sizeof(column_t<I>) * ((double)key.size() + k)))) * 1.e-9;
+        std::cerr << N << " payload columns: per-column " << seconds_per_column << " s (" << gigabytes / seconds_per_column
+                  << " GB/s), fused " << seconds_fused << " s (" << gigabytes / seconds_fused << " GB/s)" << std::endl;
+    }(std::make_index_sequence<N>{});
+}
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    // Allocate the key column, and 16 payload columns whose values are their row number:
+    auto key = std::vector<int>(n);
+    initialize(key);
+    auto columns = [n]<std::size_t... I>(std::index_sequence<I...>) {
+        auto columns = std::tuple{std::vector<column_t<I>>(n)...};
+        (std::iota(std::get<I>(columns).begin(), std::get<I>(columns).end(), column_t<I>{0}), ...);
+        return columns;
+    }(std::make_index_sequence<16>{});
+
+    auto predicate = [](int x) { return x % 3 == 0; };
+
+    // Check that the rows of the first payload column are the ones selected by the predicate:
+    std::tuple<std::vector<int>> rows;
+    std::vector<std::size_t> counts;
+    hpc::select_columns(std::tuple{std::span<const int>{key}}, predicate,
+                        std::tuple{std::span<const int>{std::get<0>(columns)}}, std::tie(std::get<0>(rows)), counts);
+    auto& r = std::get<0>(rows);
+    if (r.empty() || (long long)r.size() != std::count_if(key.begin(), key.end(), predicate)
+        || !std::is_sorted(r.begin(), r.end()) || !std::all_of(r.begin(), r.end(), [&](int i) { return predicate(key[i]); })) {
+        std::cerr << "ERROR: wrong rows selected" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool ok = [&]<std::size_t... N>(std::index_sequence<N...>) {
+        return (check_columns<N + 1>(key, predicate, columns) && ...);
+    }(std::make_index_sequence<16>{});
+    if (!ok) {
+        std::cerr << "ERROR: per-column and fused results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    [&]<std::size_t... N>(std::index_sequence<N...>) {
+        (bench_columns<N + 1>(key, predicate, columns), ...);
+    }(std::make_index_sequence<16>{});
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
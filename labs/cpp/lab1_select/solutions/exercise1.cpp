@@ -28,8 +28,8 @@
 #include <vector>
 #include <iterator>
 #include <iostream>
-#include <random>
 #include <ranges>
+#include <random.hpp>
 
 // Select elements from "v" using "pred" and copy them to "w".
 template <class UnaryPredicate>
@@ -85,9 +85,7 @@ int main(int argc, char* argv[])
 
 void initialize(std::vector<int>& v)
 {
-    auto distribution = std::uniform_int_distribution<int> {0, 100};
-    auto engine = std::mt19937 {1};
-    std::generate(v.begin(), v.end(), [&distribution, &engine]{ return distribution(engine); });
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
 }
 
 template <typename Predicate>
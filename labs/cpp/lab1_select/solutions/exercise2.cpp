@@ -23,34 +23,52 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <numeric>
 #include <vector>
 #include <iterator>
 #include <iostream>
-#include <random>
 #include <ranges>
 #include <execution>
+#include <random.hpp>
 
-// Select elements and copy them to a new vector
-template<class UnaryPredicate>
-void select(const std::vector<int>& v, UnaryPredicate pred,
-            std::vector<size_t>& index, std::vector<int>& w)
+// Select elements and copy them to a new vector, using the array "index" of v.size() values of type
+// "Index" as temporary storage
+template<class Index, class UnaryPredicate>
+void select_scan(const std::vector<int>& v, UnaryPredicate pred, Index* index, std::vector<int>& w)
 {
-    // DONE: Resize `index` to the same size as `v`.
-    index.resize(v.size());
     // DONE: use parallel `transform_inclusive_scan` to write to `index` the indices at which each selected element is to be written.
-    std::transform_inclusive_scan(std::execution::par, v.begin(), v.end(), index.begin(), std::plus<size_t>{},
-                                  [pred](int x) { return pred(x) ? 1 : 0; });
+    std::transform_inclusive_scan(std::execution::par, v.begin(), v.end(), index, std::plus<Index>{},
+                                  [pred](int x) { return pred(x) ? Index{1} : Index{0}; });
     // DONE: Resize the output `w`. The total number of output elements is the last value of the `inclusive_scan` (i.e. `index.back()`).
-    w.resize(index.empty() ? 0 : index.back());
+    w.resize(v.empty() ? 0 : index[v.size() - 1]);
     // DONE: Use parallel `for_each` statement to copy values from `v` to `w`, depending on the outcome of the unary predicate. 
     // The output index of each element is off by plus one, so need to subtract one from it.
-    std::for_each_n(std::execution::par, std::views::iota(0).begin(), (int)v.size(),
-        [pred, v = v.data(), w = w.data(), index = index.data()](int i) {
+    std::for_each_n(std::execution::par, std::views::iota(Index{0}).begin(), (Index)v.size(),
+        [pred, v = v.data(), w = w.data(), index](Index i) {
             if (pred(v[i])) w[index[i] - 1] = v[i];
     });
 }
 
+// Select elements and copy them to a new vector
+template<class UnaryPredicate>
+void select(const std::vector<int>& v, UnaryPredicate pred,
+            std::vector<size_t>& index, std::vector<int>& w)
+{
+    // The scan reads and writes one index per element of `v`. When all indices fit in 32-bit,
+    // use 32-bit indices to halve that memory traffic. They are stored in `index`, which then
+    // only needs half of its elements:
+    if (v.size() <= std::numeric_limits<std::uint32_t>::max()) {
+        index.resize((v.size() * sizeof(std::uint32_t) + sizeof(size_t) - 1) / sizeof(size_t));
+        select_scan(v, pred, reinterpret_cast<std::uint32_t*>(index.data()), w);
+    } else {
+        // DONE: Resize `index` to the same size as `v`.
+        index.resize(v.size());
+        select_scan(v, pred, index.data(), w);
+    }
+}
+
 // Initialize vector
 void initialize(std::vector<int>& v);
 
@@ -94,9 +112,7 @@ int main(int argc, char* argv[])
 
 void initialize(std::vector<int>& v)
 {
-    auto distribution = std::uniform_int_distribution<int> {0, 100};
-    auto engine = std::mt19937 {1};
-    std::generate(v.begin(), v.end(), [&distribution, &engine]{ return distribution(engine); });
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
 }
 
 template <typename Predicate>
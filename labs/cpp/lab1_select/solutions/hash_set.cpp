@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Set-membership select for sets of 10^5 to 10^7 keys: std::unordered_set::contains vs. a
+//! parallel-built open-addressing table, with and without a blocked bloom filter.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+#include <hash_set.hpp>
+#include <predicates.hpp>
+#include <random.hpp>
+
+// Initialize vector with values drawn uniformly from [0, 2^30) with the random stream "seed"
+void initialize(std::vector<int>& v, std::uint64_t seed);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    auto v = std::vector<int>(n);
+    initialize(v, 1);
+
+    std::vector<int> ref, w;
+    std::vector<std::size_t> counts;
+    auto gigabytes = sizeof(int) * (double)n * 1.e-9; // GB
+    for (std::size_t m = 100000; m <= 10000000; m *= 10) {
+        // Half of the set is drawn from the data, so that about m / 2 distinct values are selected:
+        auto keys = std::vector<int>(m);
+        initialize(keys, 2);
+        for (std::size_t i = 0; i < std::min<std::size_t>(m / 2, n); ++i) keys[i] = v[(i * 7919) % n];
+
+        std::unordered_set<int> set;
+        auto seconds_build_std = bench([&] { set = std::unordered_set<int>(keys.begin(), keys.end()); });
+        auto seconds_build_table = bench([&] { hpc::hash_set<int> table(keys); });
+        auto seconds_build_bloom = bench([&] { hpc::hash_set<int> table(keys, true); });
+        hpc::hash_set<int> table(keys), bloom(keys, true);
+
+        auto seconds_std = bench([&] { hpc::select_blocks(v, [s = &set](int x) { return s->contains(x); }, counts, ref); });
+        auto seconds_table = bench([&] { hpc::select_blocks(v, table.contains(), counts, w); });
+        if (w != ref) {
+            std::cerr << "ERROR: hash table select differs from std::unordered_set" << std::endl;
+            return EXIT_FAILURE;
+        }
+        auto seconds_bloom = bench([&] { hpc::select_blocks(v, bloom.contains(), counts, w); });
+        if (w != ref) {
+            std::cerr << "ERROR: bloom filter select differs from std::unordered_set" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cerr << m << " keys (" << ref.size() << " selected): build unordered_set " << seconds_build_std
+                  << " s, table " << seconds_build_table << " s, table + bloom " << seconds_build_bloom << " s ("
+                  << bloom.bytes() * 1.e-6 << " MB); select unordered_set " << gigabytes / seconds_std << " GB/s, table "
+                  << gigabytes / seconds_table << " GB/s, table + bloom " << gigabytes / seconds_bloom << " GB/s" << std::endl;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v, std::uint64_t seed)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, (1 << 30) - 1}, seed);
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 5;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
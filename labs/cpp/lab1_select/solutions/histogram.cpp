@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Group-by count of the select data: privatized bins vs. a shared table of atomic bins.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <histogram.hpp>
+#include <random.hpp>
+
+// Initialize vector with values drawn uniformly from [0, nbins)
+void initialize(std::vector<int>& v, int nbins);
+
+// Initialize vector with values drawn from a Zipf distribution over [0, nbins) with exponent "s"
+void initialize_zipf(std::vector<int>& v, int nbins, double s);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    auto v = std::vector<int>(n);
+    std::vector<std::size_t> bins, bins_ref;
+    std::vector<std::uint32_t> scratch;
+
+    struct input { std::string name; int nbins; double zipf; };
+    for (auto [name, nbins, zipf] : {input{"uniform", 101, 0.}, input{"zipf", 101, 1.2},
+                                     input{"uniform-high", 1 << 24, 0.}, input{"zipf-high", 1 << 24, 1.2}}) {
+        if (zipf > 0.) {
+            initialize_zipf(v, nbins, zipf);
+        } else {
+            initialize(v, nbins);
+        }
+
+        // Sequential reference:
+        bins_ref.assign(nbins, 0);
+        for (auto x : v) ++bins_ref[x];
+
+        auto gigabytes = sizeof(int) * (double)n * 1.e-9; // GB
+        std::cerr << name << " (" << nbins << " bins):";
+        for (auto [method, f] : {std::pair<std::string, std::function<void()>>{"private", [&] { hpc::histogram_private(v, nbins, bins, scratch); }},
+                                 std::pair<std::string, std::function<void()>>{"atomic", [&] { hpc::histogram_atomic(v, nbins, bins); }},
+                                 std::pair<std::string, std::function<void()>>{"auto", [&] { hpc::histogram(v, nbins, bins, scratch); }}}) {
+            auto seconds = bench(f);
+            if (bins != bins_ref) {
+                std::cerr << std::endl << "ERROR: " << method << " histogram differs from the reference" << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::cerr << " " << method << " " << gigabytes / seconds << " GB/s";
+        }
+        std::cerr << std::endl;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v, int nbins)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, nbins - 1}, 1);
+}
+
+void initialize_zipf(std::vector<int>& v, int nbins, double s)
+{
+    // Sample the rank from the inverse of the cumulative distribution, and scatter ranks over the
+    // bins with a multiplicative hash, so that the frequent keys are not all adjacent:
+    std::vector<double> cdf(nbins);
+    double sum = 0.;
+    for (int k = 0; k < nbins; ++k) cdf[k] = (sum += std::pow(k + 1., -s));
+    auto distribution = std::uniform_real_distribution<double> {0., sum};
+    auto engine = std::mt19937 {1};
+    std::generate(v.begin(), v.end(), [&] {
+        auto rank = std::lower_bound(cdf.begin(), cdf.end(), distribution(engine)) - cdf.begin();
+        return (int)(((std::uint64_t)std::min<long>(rank, nbins - 1) * 2654435761u) % nbins);
+    });
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Select on a bit-packed column: the values in [0, 100] need 7 bits instead of 32. Compares the
+//! select on the plain vector with the fused unpack + filter on the packed column, writing either
+//! the selected values or their row indices.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <vector>
+#include <packed.hpp>
+#include <predicates.hpp>
+#include <random.hpp>
+
+// Initialize vector
+void initialize(std::vector<int>& v);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    // Allocate the data vector
+    auto v = std::vector<int>(n);
+
+    initialize(v);
+
+    auto seconds_pack = bench([&] { hpc::packed_column<int> c(v); });
+    hpc::packed_column<int> c(v);
+    std::cerr << "Packed " << sizeof(int) * (double)n * 1.e-9 << " GB into " << c.bytes() * 1.e-9 << " GB in "
+              << seconds_pack << " s" << std::endl;
+
+    auto predicate = [](int x) { return x % 3 == 0; };
+    std::vector<int> ref, w;
+    std::vector<std::uint32_t> rows;
+    std::vector<std::size_t> counts;
+    auto seconds_plain = bench([&] { hpc::select_blocks(v, predicate, counts, ref); });
+    auto seconds_packed = bench([&] { hpc::select(c, predicate, counts, w); });
+    auto seconds_rows = bench([&] { hpc::select_rows(c, predicate, counts, rows); });
+
+    if (w != ref || rows.size() != ref.size()
+        || !std::all_of(rows.begin(), rows.end(), [&](auto i) { return predicate(v[i]); })
+        || !std::is_sorted(rows.begin(), rows.end())) {
+        std::cerr << "ERROR: packed select differs from the plain select" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    // Bandwidth in [GB/s] of the uncompressed input, i.e., values selected per unit of time:
+    auto gigabytes = sizeof(int) * (double)n * 1.e-9; // GB
+    std::cerr << "plain: " << gigabytes / seconds_plain << " GB/s, packed values: " << gigabytes / seconds_packed
+              << " GB/s, packed rows: " << gigabytes / seconds_rows << " GB/s" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
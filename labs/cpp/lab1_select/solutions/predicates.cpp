@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Chains of 1 to 8 predicates: one select per predicate vs. a single fused pass.
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <tuple>
+#include <vector>
+#include <predicates.hpp>
+#include <random.hpp>
+
+// Select elements from "v" using "pred" and copy them to "w".
+template <class UnaryPredicate>
+void select(const std::vector<int>& v, UnaryPredicate pred, std::vector<int>& w)
+{
+    w.resize(std::count_if(std::execution::par, v.begin(), v.end(), pred));
+    std::copy_if(std::execution::par, v.begin(), v.end(), w.begin(), pred);
+}
+
+// Initialize vector
+void initialize(std::vector<int>& v);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+// Benchmarks a chain of the first "N" predicates in "preds"; returns false if the results differ.
+template <std::size_t N, class Predicates>
+bool bench_chain(const std::vector<int>& v, const Predicates& preds)
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        // Chained: each select reads the output of the previous one.
+        std::vector<int> bufs[2];
+        const std::vector<int>* chained = &v;
+        auto run_chained = [&] {
+            chained = &v;
+            int k = 0;
+            ((select(*chained, std::get<I>(preds), bufs[k % 2]), chained = &bufs[k++ % 2]), ...);
+        };
+
+        // Fused: one pass evaluating all predicates without branches.
+        auto fused = hpc::and_{std::get<I>(preds)...};
+        std::vector<std::size_t> counts;
+        std::vector<int> w_fused;
+        auto run_fused = [&] { hpc::select_blocks(v, fused, counts, w_fused); };
+
+        // Reordered: one pass evaluating the predicates in order of measured cost and selectivity.
+        auto reordered = hpc::reordered_and{std::get<I>(preds)...};
+        reordered.calibrate(v.data(), std::min(v.size(), std::size_t{1} << 16));
+        std::vector<int> w_reordered;
+        auto run_reordered = [&] { hpc::select_blocks(v, reordered, counts, w_reordered); };
+
+        auto seconds_chained = bench(run_chained);
+        auto seconds_fused = bench(run_fused);
+        auto seconds_reordered = bench(run_reordered);
+
+        auto gigabytes = sizeof(int) * (double)v.size() * 1.e-9; // GB
+        std::cerr << N << " predicates, selectivity " << (double)w_fused.size() / (double)v.size()
+                  << ": chained " << gigabytes / seconds_chained << " GB/s, fused "
+                  << gigabytes / seconds_fused << " GB/s, reordered "
+                  << gigabytes / seconds_reordered << " GB/s, order:";
+        for (auto i : reordered.order) std::cerr << " " << i;
+        std::cerr << std::endl;
+
+        return *chained == w_fused && w_fused == w_reordered && std::all_of(w_fused.begin(), w_fused.end(), fused);
+    }(std::make_index_sequence<N>{});
+}
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    // Allocate the data vector
+    auto v = std::vector<int>(n);
+
+    initialize(v);
+
+    // Predicates with different costs and selectivities on the uniform [0, 100] input:
+    auto preds = std::tuple{
+        hpc::range{0, 95},
+        hpc::not_{hpc::in_set{1, 2, 3, 4, 5, 6, 7, 8}},
+        [](int x) { return x % 3 != 1; },
+        hpc::range{10, 101},
+        [](int x) { return x % 7 != 0; },
+        hpc::in_set{0, 6, 12, 18, 24, 30, 36, 42, 48, 54, 60, 66, 72, 78, 84, 90, 96},
+        hpc::or_{hpc::range{0, 50}, [](int x) { return x % 2 == 0; }},
+        hpc::not_{hpc::range{40, 45}},
+    };
+
+    bool ok = [&]<std::size_t... N>(std::index_sequence<N...>) {
+        return (bench_chain<N + 1>(v, preds) & ...);
+    }(std::make_index_sequence<std::tuple_size_v<decltype(preds)>>{});
+    if (!ok) {
+        std::cerr << "ERROR: chained and fused results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
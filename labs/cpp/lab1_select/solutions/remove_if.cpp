@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! In-place select: compacts "v" without a second buffer of the same size.
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <vector>
+#include <sys/resource.h>
+#include <compact.hpp>
+#include <random.hpp>
+
+// Select elements from "v" using "pred" and copy them to "w".
+template <class UnaryPredicate>
+void select(const std::vector<int>& v, UnaryPredicate pred, std::vector<int>& w)
+{
+    w.resize(std::count_if(std::execution::par, v.begin(), v.end(), pred));
+    std::copy_if(std::execution::par, v.begin(), v.end(), w.begin(), pred);
+}
+
+// Select elements from "v" using "pred" in place, keeping their order.
+template <class UnaryPredicate>
+void select_in_place(std::vector<int>& v, UnaryPredicate pred, std::vector<int>& scratch)
+{
+    v.resize(hpc::remove_if(v, [pred](int x) { return !pred(x); }, scratch));
+}
+
+// Initialize vector
+void initialize(std::vector<int>& v);
+
+// Peak resident set size of the process in [MB]
+double peak_rss_mb() {
+    rusage r;
+    getrusage(RUSAGE_SELF, &r);
+    return (double)r.ru_maxrss * 1.e-3;
+}
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    auto predicate = [](int x) { return x % 3 == 0; };
+    using clk_t = std::chrono::steady_clock;
+    int nit = 5;
+
+    // The in-place version runs first, since the peak RSS of a process never decreases:
+    auto v = std::vector<int>(n);
+    std::vector<int> scratch;
+    initialize(v);
+    auto rss_input = peak_rss_mb();
+    double seconds_in_place = 0.;
+    for (int it = 0; it < nit; ++it) {
+        v.resize(n);
+        initialize(v);
+        auto start = clk_t::now();
+        select_in_place(v, predicate, scratch);
+        seconds_in_place += std::chrono::duration<double>(clk_t::now() - start).count();
+    }
+    auto rss_in_place = peak_rss_mb();
+
+    std::vector<int> w;
+    v.resize(n);
+    initialize(v);
+    double seconds_out_of_place = 0.;
+    for (int it = 0; it < nit; ++it) {
+        auto start = clk_t::now();
+        select(v, predicate, w);
+        seconds_out_of_place += std::chrono::duration<double>(clk_t::now() - start).count();
+    }
+    auto rss_out_of_place = peak_rss_mb();
+
+    select_in_place(v, predicate, scratch);
+    if (v != w || w.empty() || !std::all_of(w.begin(), w.end(), predicate)) {
+        std::cerr << "ERROR! ";
+        std::cout << "v[0.." << std::min(10, (int)v.size()) << "] = ";
+        std::copy(v.begin(), v.begin() + std::min(10, (int)v.size()), std::ostream_iterator<int>(std::cout, " "));
+        std::cout << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    auto gigabytes = sizeof(int) * (double)n * 1.e-9; // GB
+    std::cerr << "Problem size: " << gigabytes << " GB, input peak RSS: " << rss_input << " MB" << std::endl;
+    std::cerr << "In-place:     " << seconds_in_place / nit << " s, peak RSS +"
+              << (rss_in_place - rss_input) << " MB (scratch: " << scratch.size() * sizeof(int) * 1.e-6 << " MB)" << std::endl;
+    std::cerr << "Out-of-place: " << seconds_out_of_place / nit << " s, peak RSS +"
+              << (rss_out_of_place - rss_input) << " MB" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
+}
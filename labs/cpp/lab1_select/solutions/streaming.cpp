@@ -0,0 +1,204 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Streaming select over a binary column of `int`s stored in a file, which may not fit in memory.
+//!
+//! The file is read in fixed-size chunks with `pread`. While one chunk is filtered in parallel,
+//! the next one is read in the background, and the survivors of the previous one are appended
+//! to the output file, so that all writes are ordered and contiguous.
+//!
+//! Usage:
+//!   ./select <n>                    writes n random values to "input", filters them to "output"
+//!   ./select <input> <output>       filters an existing column
+//!   ./select <input> <output> <MB>  ... with a chunk size of <MB> megabytes (default: 64)
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <random.hpp>
+
+// Select elements from [first, last) using "pred" and copy them to "out".
+// Returns the number of selected elements.
+template <class UnaryPredicate>
+std::size_t select(const int* first, const int* last, UnaryPredicate pred, int* out)
+{
+    return std::copy_if(std::execution::par, first, last, out, pred) - out;
+}
+
+// Reads up to "n" values at value offset "offset" of file "fd" into "buf", returns the number read.
+std::size_t read_chunk(int fd, std::size_t offset, std::size_t n, int* buf);
+
+// Appends "n" values to file "fd".
+void write_chunk(int fd, const int* buf, std::size_t n);
+
+// Writes a column of "n" pseudo-random values in [0, 100] to "path" one chunk at a time.
+void initialize(const std::string& path, long long n, std::size_t chunk);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc < 2 || argc > 4) {
+        std::cerr << "ERROR: incorrect arguments" << std::endl;
+        std::cerr << "  " << argv[0] << " <n> | <input> <output> [chunk MB]" << std::endl;
+        return 1;
+    }
+    long long chunk_mb = argc == 4 ? std::stoll(argv[3]) : 64;
+    if (chunk_mb <= 0) {
+        std::cerr << "ERROR: the chunk size must be a positive number of MB" << std::endl;
+        std::cerr << "  " << argv[0] << " <n> | <input> <output> [chunk MB]" << std::endl;
+        return 1;
+    }
+    std::size_t chunk = chunk_mb * (1 << 20) / sizeof(int);
+    std::string input = "input", output = "output";
+    if (argc == 2) {
+        initialize(input, std::stoll(argv[1]), chunk);
+    } else {
+        input = argv[1];
+        output = argv[2];
+    }
+
+    int in = open(input.c_str(), O_RDONLY);
+    int out = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (in < 0 || out < 0) {
+        std::cerr << "ERROR: cannot open " << (in < 0 ? input : output) << std::endl;
+        return 1;
+    }
+    std::size_t n = lseek(in, 0, SEEK_END) / sizeof(int);
+
+    using clk_t = std::chrono::steady_clock;
+    std::vector<int> buf[2] = {std::vector<int>(chunk), std::vector<int>(chunk)};
+    std::vector<int> sel[2] = {std::vector<int>(chunk), std::vector<int>(chunk)};
+
+    // Raw read bandwidth: read the file chunk by chunk without doing anything else.
+    // Cached pages are dropped first, so that both passes read from the disk.
+    posix_fadvise(in, 0, 0, POSIX_FADV_DONTNEED);
+    auto start = clk_t::now();
+    for (std::size_t i = 0; i < n; i += chunk) read_chunk(in, i, chunk, buf[0].data());
+    auto seconds_read = std::chrono::duration<double>(clk_t::now() - start).count();
+
+    // Streaming select:
+    auto predicate = [](int x) { return x % 3 == 0; };
+    posix_fadvise(in, 0, 0, POSIX_FADV_DONTNEED);
+    start = clk_t::now();
+    std::size_t count = 0;
+    std::future<std::size_t> next_read =
+        std::async(std::launch::async, read_chunk, in, 0, chunk, buf[0].data());
+    std::future<void> prev_write;
+    for (std::size_t i = 0, c = 0; i < n; i += chunk, c ^= 1) {
+        auto m = next_read.get();
+        // Read ahead the next chunk into the other buffer:
+        if (i + chunk < n) {
+            next_read = std::async(std::launch::async, read_chunk, in, i + chunk, chunk, buf[c ^ 1].data());
+        }
+        auto k = select(buf[c].data(), buf[c].data() + m, predicate, sel[c].data());
+        // Writes are issued in chunk order, each one after the previous one completed:
+        if (prev_write.valid()) prev_write.get();
+        prev_write = std::async(std::launch::async, write_chunk, out, sel[c].data(), k);
+        count += k;
+    }
+    if (prev_write.valid()) prev_write.get();
+    auto seconds_select = std::chrono::duration<double>(clk_t::now() - start).count();
+    close(out);
+
+    // Check the output file size, and each chunk of the output against the select of the
+    // corresponding chunk of the input:
+    out = open(output.c_str(), O_RDONLY);
+    bool ok = count > 0 && (std::size_t)lseek(out, 0, SEEK_END) == count * sizeof(int);
+    for (std::size_t i = 0, offset = 0; ok && i < n; i += chunk) {
+        auto m = read_chunk(in, i, chunk, buf[0].data());
+        auto k = select(buf[0].data(), buf[0].data() + m, predicate, sel[0].data());
+        ok = read_chunk(out, offset, k, buf[1].data()) == k
+            && std::equal(sel[0].begin(), sel[0].begin() + k, buf[1].begin());
+        offset += k;
+    }
+    close(in);
+    close(out);
+    if (!ok) {
+        std::cerr << "ERROR: output does not match the select of the input" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "Check: OK, ";
+
+    auto gigabytes = sizeof(int) * (double)n * 1.e-9; // GB
+    std::cerr << "Problem size: " << gigabytes << " GB, selected " << count << " values, "
+              << "Raw read [GB/s]: " << gigabytes / seconds_read
+              << ", Streaming select [GB/s]: " << gigabytes / seconds_select
+              << " (" << 100. * seconds_read / seconds_select << "% of raw read)" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+std::size_t read_chunk(int fd, std::size_t offset, std::size_t n, int* buf)
+{
+    auto bytes = n * sizeof(int);
+    auto done = std::size_t{0};
+    while (done < bytes) {
+        auto r = pread(fd, (char*)buf + done, bytes - done, offset * sizeof(int) + done);
+        if (r < 0) {
+            std::cerr << "ERROR: read failed" << std::endl;
+            std::terminate();
+        }
+        if (r == 0) break; // End of file
+        done += r;
+    }
+    return done / sizeof(int);
+}
+
+void write_chunk(int fd, const int* buf, std::size_t n)
+{
+    auto bytes = n * sizeof(int);
+    auto done = std::size_t{0};
+    while (done < bytes) {
+        auto r = write(fd, (const char*)buf + done, bytes - done);
+        if (r < 0) {
+            std::cerr << "ERROR: write failed" << std::endl;
+            std::terminate();
+        }
+        done += r;
+    }
+}
+
+void initialize(const std::string& path, long long n, std::size_t chunk)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "ERROR: cannot open " << path << std::endl;
+        std::terminate();
+    }
+    // Each chunk continues the sequence at its global index "i", so the file does not depend on the
+    // chunk size:
+    std::vector<int> v;
+    for (long long i = 0; i < n; i += chunk) {
+        v.resize(std::min((long long)chunk, n - i));
+        hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1, i);
+        write_chunk(fd, v.data(), v.size());
+    }
+    fsync(fd);
+    close(fd);
+}
@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Selectivity sweep: compares the select engines from 0% to 100% selectivity, for matches
+//! spread at random or clustered in runs, using the bytes each engine actually moves.
+//!
+//! Output: one line per pattern, selectivity and engine:
+//!   <pattern> <selectivity> <engine> <time [s]> <traffic [GB]> <bandwidth [GB/s]>
+//! followed by "Check: OK" once the results of all engines agree with copy_if.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+#include <bitmap.hpp>
+#include <compact.hpp>
+#include <packed.hpp>
+#include <predicates.hpp>
+#include <random.hpp>
+#include <select.hpp>
+#include <workspace.hpp>
+
+// Initialize vector with values in [0, 100) drawn at random for each element.
+void initialize(std::vector<int>& v);
+
+// Initialize vector with values in [0, 100) drawn at random for each run of "run" elements.
+void initialize_clustered(std::vector<int>& v, std::size_t run);
+
+// Returns the average time in [s] of one call to "f", calling "setup" untimed before each call.
+template <typename S, typename F>
+double bench(S&& setup, F&& f);
+
+// Number of bytes of the 64-byte cache lines of "v" that contain at least one selected element.
+// These are the bytes read by engines that only touch the selected elements of "v".
+template <class UnaryPredicate>
+double selected_lines_bytes(const std::vector<int>& v, UnaryPredicate pred);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    std::vector<int> random(n), clustered(n);
+    initialize(random);
+    initialize_clustered(clustered, 1024);
+
+    std::vector<int> w, w_ref, u, scratch;
+    std::vector<std::uint32_t> index32;
+    std::vector<std::size_t> index, offsets;
+    hpc::bitmap b;
+    hpc::workspace ws;
+    std::span<int> unordered;
+
+    for (auto [pattern, v] : {std::pair{"random", &random}, std::pair{"clustered", &clustered}}) {
+        hpc::packed_column<int> c(*v);
+        for (int t : {0, 1, 10, 25, 50, 75, 90, 99, 100}) {
+            auto pred = [t](int x) { return x < t; };
+            hpc::select_copy_if(*v, pred, w_ref);
+            double k = w_ref.size(), nn = n, packed = c.bytes();
+            auto lines = selected_lines_bytes(*v, pred);
+
+            // Traffic model [bytes] of each engine: every read or written byte is counted once,
+            // reads of "v" that only touch selected elements count whole cache lines.
+            // The result of each engine is checked in "out" against copy_if.
+            struct engine {
+                std::string name;
+                double bytes;
+                std::function<void()> setup, run;
+                std::vector<int>* out;
+            };
+            auto none = [] {};
+            engine engines[] = {
+                // count_if reads v; copy_if reads v and writes the selection:
+                {"copy_if", 8 * nn + 4 * k, none, [&] { hpc::select_copy_if(*v, pred, w); }, &w},
+                // The scan reads v and writes the index; the scatter reads v and the index, and
+                // writes the selection:
+                {"scan32", 16 * nn + 4 * k, none,
+                 [&] { hpc::select_scan(*v, pred, index32, w); }, &w},
+                {"scan64", 24 * nn + 4 * k, none,
+                 [&] { hpc::select_scan(*v, pred, index, w); }, &w},
+                // The bitmap is written and read twice, the word offsets are written and read
+                // once, and the gather reads the selected lines of v and writes the selection:
+                {"bitmap", 4 * nn + 5 * nn / 8 + lines + 4 * k, none, [&] {
+                    hpc::select_bitmap(*v, pred, b);
+                    hpc::word_offsets(b, offsets);
+                    hpc::gather(*v, b, offsets, w);
+                }, &w},
+                // The first pass reads v and writes the 16-bit indices of the matches of each
+                // block; the second reads them and the selected lines of v, and writes the
+                // selection:
+                {"blocks", 6 * nn + lines + 6 * k, none,
+                 [&] { hpc::select_blocks(*v, pred, offsets, w); }, &w},
+                // Both passes unpack the packed column, the second one writes the selection:
+                {"packed", 2 * packed + 4 * k, none, [&] { hpc::select(c, pred, offsets, w); }, &w},
+                // The second pass reads the block of v from cache, and writes the selection:
+                {"unordered", 4 * nn + 4 * k, [&] { ws.reset(); },
+                 [&] { unordered = hpc::select_unordered(*v, pred, ws); }, &u},
+                // The selection is written to scratch, read back, and written to v:
+                {"in-place", 4 * nn + 12 * k, [&] { u = *v; }, [&] {
+                    u.resize(hpc::remove_if(u, [pred](int x) { return !pred(x); }, scratch));
+                }, &u},
+            };
+            // The unordered engine is checked against a sorted copy of the reference:
+            auto w_sorted = w_ref;
+            std::sort(w_sorted.begin(), w_sorted.end());
+            for (auto& e : engines) {
+                auto seconds = bench(e.setup, e.run);
+                auto& ref = e.name == "unordered" ? w_sorted : w_ref;
+                if (e.name == "unordered") {
+                    u.assign(unordered.begin(), unordered.end());
+                    std::sort(u.begin(), u.end());
+                }
+                if (*e.out != ref) {
+                    std::cerr << "ERROR: " << e.name << " differs from copy_if" << std::endl;
+                    return EXIT_FAILURE;
+                }
+                auto gigabytes = e.bytes * 1.e-9;
+                std::cerr << pattern << " " << k / nn << " " << e.name << " " << seconds << " "
+                          << gigabytes << " " << gigabytes / seconds << std::endl;
+            }
+        }
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 99}, 1);
+}
+
+void initialize_clustered(std::vector<int>& v, std::size_t run)
+{
+    auto distribution = std::uniform_int_distribution<int> {0, 99};
+    auto engine = std::mt19937 {1};
+    for (std::size_t i = 0; i < v.size(); i += run) {
+        std::fill_n(v.begin() + i, std::min(run, v.size() - i), distribution(engine));
+    }
+}
+
+template <typename S, typename F>
+double bench(S&& setup, F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    setup();
+    f();
+    double seconds = 0.;
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        setup();
+        auto start = clk_t::now();
+        f();
+        seconds += std::chrono::duration<double>(clk_t::now() - start).count();
+    }
+    return seconds / nit;
+}
+
+template <class UnaryPredicate>
+double selected_lines_bytes(const std::vector<int>& v, UnaryPredicate pred)
+{
+    constexpr std::size_t line = 64 / sizeof(int);
+    auto nlines = (v.size() + line - 1) / line;
+    auto ls = std::views::iota(std::size_t{0}, nlines);
+    return 64. * std::transform_reduce(std::execution::par, ls.begin(), ls.end(), std::size_t{0}, std::plus{},
+        [pred, v = v.data(), n = v.size()](std::size_t l) {
+            return std::any_of(v + l * line, v + std::min((l + 1) * line, n), pred) ? 1 : 0;
+        });
+}
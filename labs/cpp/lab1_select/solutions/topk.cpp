@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Top-k: per-chunk heaps and sampling + select vs. parallel std::nth_element, for k in [10, 10^6].
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <functional>
+#include <iostream>
+#include <vector>
+#include <random.hpp>
+#include <topk.hpp>
+
+// Initialize vector. The values are drawn from a range much wider than the [0, 100] of the other
+// select examples, since with only 101 distinct values the top-k are mostly equal.
+void initialize(std::vector<int>& v);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+// Returns the average time in [s] of one call to "f", without the call to "setup" before each.
+template <typename Setup, typename F>
+double bench(Setup&& setup, F&& f);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    // Allocate the data vector
+    auto v = std::vector<int>(n);
+
+    initialize(v);
+
+    std::vector<int> ref, w, scratch;
+    auto gigabytes = sizeof(int) * (double)n * 1.e-9; // GB
+    for (std::size_t k = 10; k <= std::min<std::size_t>(1000000, n); k *= 10) {
+        // Reference: parallel nth_element on a copy of the input, which is not timed, and sort of the
+        // k largest
+        auto seconds_ref = bench([&] { ref = v; }, [&] {
+            std::nth_element(std::execution::par, ref.begin(), ref.begin() + (k - 1), ref.end(), std::greater<>{});
+            ref.resize(k);
+            std::sort(std::execution::par, ref.begin(), ref.end(), std::greater<>{});
+        });
+
+        std::vector<int> w_heaps, w_sample;
+        auto top_k_with = [&](auto candidates, std::vector<int>& out) {
+            candidates(v, k, out);
+            std::nth_element(std::execution::par, out.begin(), out.begin() + (k - 1), out.end(), std::greater<>{});
+            out.resize(k);
+            std::sort(std::execution::par, out.begin(), out.end(), std::greater<>{});
+        };
+        auto seconds_heaps = bench([&] { top_k_with([](auto&&... a) { hpc::top_k_candidates_heaps(a...); }, w_heaps); });
+        auto seconds_sample = bench([&] { top_k_with([](auto&&... a) { hpc::top_k_candidates_sample(a...); }, w_sample); });
+        hpc::top_k(v, k, w);
+        auto kth = hpc::kth_largest(v, k, scratch);
+
+        if (w != ref || w_heaps != ref || w_sample != ref || kth != ref.back()) {
+            std::cerr << "ERROR: top-" << k << " differs from nth_element" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cerr << "k = " << k << ": nth_element " << gigabytes / seconds_ref << " GB/s, heaps "
+                  << gigabytes / seconds_heaps << " GB/s, sample " << gigabytes / seconds_sample << " GB/s" << std::endl;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 1 << 30}, 1);
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 5;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
+
+template <typename Setup, typename F>
+double bench(Setup&& setup, F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    setup();
+    f();
+    clk_t::duration time{};
+    int nit = 5;
+    for (int it = 0; it < nit; ++it) {
+        setup();
+        auto start = clk_t::now();
+        f();
+        time += clk_t::now() - start;
+    }
+    return std::chrono::duration<double>(time).count() / nit;
+}
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Unique and run-length encoding: blocked parallel kernels vs. std::unique with the parallel
+//! execution policy, on sorted data (long runs, spanning many blocks) and on unsorted data.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random.hpp>
+#include <rle.hpp>
+
+// Initialize vector
+void initialize(std::vector<int>& v);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+// Returns the average time in [s] of one call to "f", without the call to "setup" before each.
+template <typename Setup, typename F>
+double bench(Setup&& setup, F&& f);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    auto v = std::vector<int>(n);
+    initialize(v);
+    auto sorted = v;
+    std::sort(std::execution::par, sorted.begin(), sorted.end());
+
+    std::vector<int> ref, w, values, decoded;
+    std::vector<std::uint32_t> lengths;
+    std::vector<std::size_t> counts, starts, offsets;
+    auto gigabytes = sizeof(int) * (double)n * 1.e-9; // GB
+    for (auto [name, input] : {std::pair<std::string, std::vector<int>*>{"sorted", &sorted}, {"unsorted", &v}}) {
+        auto& x = *input;
+        // std::unique is in-place, so the copy of the input to its output is not timed:
+        auto seconds_std = bench([&] { ref = x; },
+                                 [&] { ref.erase(std::unique(std::execution::par, ref.begin(), ref.end()), ref.end()); });
+        auto seconds_unique = bench([&] { hpc::unique(x, w, counts); });
+        std::size_t count = 0;
+        auto seconds_count = bench([&] { count = hpc::unique_count(x); });
+        auto seconds_encode = bench([&] { hpc::rle_encode(x, values, lengths, starts, counts); });
+        auto seconds_decode = bench([&] { hpc::rle_decode(values, lengths, decoded, offsets); });
+
+        if (w != ref || count != ref.size() || values != ref || decoded != x) {
+            std::cerr << "ERROR: " << name << " results differ from std::unique" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cerr << name << " (" << ref.size() << " runs): std::unique " << gigabytes / seconds_std
+                  << " GB/s, unique " << gigabytes / seconds_unique << " GB/s, unique_count " << gigabytes / seconds_count
+                  << " GB/s, rle_encode " << gigabytes / seconds_encode << " GB/s, rle_decode "
+                  << gigabytes / seconds_decode << " GB/s" << std::endl;
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, 1);
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
+
+template <typename Setup, typename F>
+double bench(Setup&& setup, F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    setup();
+    f();
+    clk_t::duration time{};
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        setup();
+        auto start = clk_t::now();
+        f();
+        time += clk_t::now() - start;
+    }
+    return std::chrono::duration<double>(time).count() / nit;
+}
@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Unordered select, with one atomic output reservation per block and no scan, vs. the ordered
+//! scan-based and copy_if-based selects, across selectivities and thread counts.
+//!
+//! With the TBB backend, the thread counts are swept with tbb::global_control. Other backends use
+//! their default number of threads, e.g., OMP_NUM_THREADS with nvc++ -stdpar=multicore.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <thread>
+#include <vector>
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#endif
+#include <random.hpp>
+#include <select.hpp>
+#include <workspace.hpp>
+
+// Initialize vector
+void initialize(std::vector<int>& v);
+
+// Returns the average time in [s] of one call to "f".
+template <typename F>
+double bench(F&& f);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    // Allocate the data vector
+    auto v = std::vector<int>(n);
+
+    initialize(v);
+
+    std::vector<unsigned> thread_counts{std::max(1u, std::thread::hardware_concurrency())};
+#if __has_include(<tbb/global_control.h>)
+    thread_counts.clear();
+    for (unsigned t = 1; t < std::thread::hardware_concurrency(); t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(std::max(1u, std::thread::hardware_concurrency()));
+#endif
+
+    hpc::workspace ws;
+    std::vector<int> ordered, unordered;
+    for (auto threads : thread_counts) {
+#if __has_include(<tbb/global_control.h>)
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, threads);
+#endif
+        // Predicate "x < t" selects t% of the values in [0, 100):
+        for (int t : {1, 10, 50, 90, 100}) {
+            auto predicate = [t](int x) { return x < t; };
+            auto run = [&](auto select) {
+                return bench([&] {
+                    ws.reset();
+                    select(v, predicate, ws);
+                });
+            };
+            auto seconds_scan = run([](auto&&... a) { return hpc::select_scan(a...); });
+            auto seconds_copy_if = run([](auto&&... a) { return hpc::select_copy_if(a...); });
+            auto seconds_unordered = run([](auto&&... a) { return hpc::select_unordered(a...); });
+
+            // The unordered select must return the same elements, in any order:
+            ws.reset();
+            auto s = hpc::select_scan(v, predicate, ws);
+            ordered.assign(s.begin(), s.end());
+            auto u = hpc::select_unordered(v, predicate, ws);
+            unordered.assign(u.begin(), u.end());
+            std::sort(std::execution::par, ordered.begin(), ordered.end());
+            std::sort(std::execution::par, unordered.begin(), unordered.end());
+            if (ordered != unordered) {
+                std::cerr << "ERROR: unordered select differs from the ordered one" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            // Bytes read from the input plus bytes written to the output:
+            auto gigabytes = sizeof(int) * ((double)n + (double)s.size()) * 1.e-9; // GB
+            std::cerr << threads << " threads, " << (double)s.size() / std::max(1., (double)n) * 100.
+                      << "% selected: scan " << gigabytes / seconds_scan << " GB/s, copy_if "
+                      << gigabytes / seconds_copy_if << " GB/s, unordered " << gigabytes / seconds_unordered
+                      << " GB/s" << std::endl;
+        }
+    }
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 99}, 1);
+}
+
+template <typename F>
+double bench(F&& f) {
+    using clk_t = std::chrono::steady_clock;
+    f();
+    auto start = clk_t::now();
+    int nit = 10;
+    for (int it = 0; it < nit; ++it) {
+        f();
+    }
+    return std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+}
@@ -0,0 +1,152 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Repeated select over batches of varying size and selectivity, as in a service loop: new
+//! vectors per batch, vectors reused across batches, and a reusable workspace.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <execution>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <vector>
+#include <random.hpp>
+#include <select.hpp>
+#include <workspace.hpp>
+
+// Count the calls to the global operator new, to check that the steady state does not allocate:
+std::atomic<std::size_t> allocations{0};
+void* operator new(std::size_t bytes)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto p = std::malloc(bytes == 0 ? 1 : bytes)) return p;
+    throw std::bad_alloc{};
+}
+void* operator new(std::size_t bytes, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    auto a = static_cast<std::size_t>(alignment);
+    if (auto p = std::aligned_alloc(a, std::max(a, (bytes + a - 1) / a * a))) return p;
+    throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Initialize vector
+void initialize(std::vector<int>& v, std::uint64_t seed);
+
+int main(int argc, char* argv[])
+{
+    // Read CLI arguments, the first argument is the name of the binary:
+    if (argc != 2) {
+        std::cerr << "ERROR: Missing length argument!" << std::endl;
+        return 1;
+    }
+
+    // Read length of vector elements
+    long long n = std::stoll(argv[1]);
+
+    // Batches with between n / 2 and n elements, each selected with a threshold in [10, 90):
+    constexpr int nbatches = 8;
+    auto sizes = hpc::uniform_real_distribution<double> {.5, 1.};
+    auto thresholds = hpc::uniform_int_distribution<int> {10, 89};
+    std::vector<std::vector<int>> batches(nbatches);
+    for (int b = 0; b < nbatches; ++b) {
+        batches[b].resize((long long)(sizes(3, b) * (double)n));
+        initialize(batches[b], b);
+    }
+
+    std::vector<std::uint32_t> index32;
+    std::vector<std::size_t> index;
+    std::vector<int> w;
+    hpc::workspace ws;
+
+    // New vectors for the scratch and the result of each batch; the result is handed to "w":
+    auto fresh = [&](int b) {
+        std::vector<std::uint32_t> index32;
+        std::vector<std::size_t> index;
+        std::vector<int> result;
+        hpc::select_scan(batches[b], [t = thresholds(4, b)](int x) { return x < t; }, index32, index, result);
+        w = std::move(result);
+        return w.size();
+    };
+    auto reused = [&](int b) {
+        hpc::select_scan(batches[b], [t = thresholds(4, b)](int x) { return x < t; }, index32, index, w);
+        return w.size();
+    };
+    auto workspace = [&](int b) {
+        ws.reset();
+        return hpc::select_scan(batches[b], [t = thresholds(4, b)](int x) { return x < t; }, ws).size();
+    };
+
+    // Check that the workspace select returns the same elements, and add up the bytes moved by the
+    // scan-based select of each batch: the scan reads the batch and writes the index, the scatter
+    // reads both again, and writes the selected elements.
+    auto gigabytes = 0.;
+    for (int b = 0; b < nbatches; ++b) {
+        auto k = (double)reused(b), nb = (double)batches[b].size();
+        auto index_bytes = batches[b].size() <= std::numeric_limits<std::uint32_t>::max()
+                               ? sizeof(std::uint32_t) : sizeof(std::size_t);
+        gigabytes += (2. * (sizeof(int) + index_bytes) * nb + sizeof(int) * k) * 1.e-9; // GB
+        ws.reset();
+        auto r = hpc::select_scan(batches[b], [t = thresholds(4, b)](int x) { return x < t; }, ws);
+        if (!std::equal(r.begin(), r.end(), w.begin(), w.end())) {
+            std::cerr << "ERROR: workspace select differs in batch " << b << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (auto [name, f] : {std::pair<const char*, std::function<std::size_t(int)>>{"new vectors", fresh},
+                           {"reused vectors", reused}, {"workspace", workspace}}) {
+        // Warm up with one pass over all batches, then measure the steady state:
+        for (int b = 0; b < nbatches; ++b) f(b);
+        using clk_t = std::chrono::steady_clock;
+        int nit = 5;
+        auto before = allocations.load();
+        auto start = clk_t::now();
+        for (int it = 0; it < nit; ++it) {
+            for (int b = 0; b < nbatches; ++b) f(b);
+        }
+        auto seconds = std::chrono::duration<double>(clk_t::now() - start).count() / nit;
+        auto per_batch = (double)(allocations.load() - before) / (nit * nbatches);
+        std::cerr << name << ": " << seconds / nbatches << " s per batch, " << gigabytes / seconds << " GB/s, "
+                  << per_batch << " allocations per batch" << std::endl;
+    }
+    std::cerr << "Workspace high-water mark: " << ws.high_water() * 1.e-9 << " GB, " << ws.allocations()
+              << " allocations in total" << std::endl;
+    std::cerr << "Check: OK" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+void initialize(std::vector<int>& v, std::uint64_t seed)
+{
+    hpc::generate(v, hpc::uniform_int_distribution<int> {0, 100}, seed);
+}
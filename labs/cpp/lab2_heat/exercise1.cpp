@@ -149,19 +149,21 @@ int main(int argc, char *argv[]) {
               << memory_bw * p.nranks << " GB/s" << std::endl; 
   }
 
-  // Write output to file
+  // Write output to file: a header with the global extents, the bytes per value and the end time,
+  // followed by the values.
   MPI_File f;
   MPI_File_open(MPI_COMM_WORLD, "output", MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &f);
-  auto header_bytes = 2 * sizeof(long) + sizeof(double);
+  auto header_bytes = 3 * sizeof(long) + sizeof(double);
   auto values_per_rank = p.nx * p.ny;
   auto values_bytes_per_rank = values_per_rank * sizeof(double);
   MPI_File_set_size(f, header_bytes + values_bytes_per_rank * p.nranks);
   MPI_Request req[3] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  // The header must outlive the non-blocking writes, which complete in MPI_Waitall:
+  long total[3] = {p.nx * p.nranks, p.ny, sizeof(double)};
+  double end_time = p.nit() * p.dt;
   if (p.rank == 0) {
-    long total[2] = {p.nx * p.nranks, p.ny};
-    double time = p.nit() * p.dt;
-    MPI_File_iwrite_at(f, 0, total, 2, MPI_UINT64_T, &req[1]);
-    MPI_File_iwrite_at(f, 2 * sizeof(long), &time, 1, MPI_DOUBLE, &req[2]);
+    MPI_File_iwrite_at(f, 0, total, 3, MPI_UINT64_T, &req[1]);
+    MPI_File_iwrite_at(f, 3 * sizeof(long), &end_time, 1, MPI_DOUBLE, &req[2]);
   }
   auto values_offset = header_bytes + p.rank * values_bytes_per_rank;
   auto u_out_data = std::vector<double>(p.n());
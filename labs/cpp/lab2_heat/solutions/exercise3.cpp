@@ -88,7 +88,7 @@ stde::sender auto iteration_step(stde::scheduler auto&& sch, parameters& p, long
          });
 }
 
-void initial_condition(double* u_new, double* u_old, long n);
+void initial_condition(double* u_new, double* u_old, parameters p);
 
 int main(int argc, char *argv[]) {
   // Parse CLI parameters
@@ -108,7 +108,7 @@ int main(int argc, char *argv[]) {
   std::vector<double> u_new(p.n()), u_old(p.n());
  
   // Initial condition
-  initial_condition(u_new.data(), u_old.data(), p.n());
+  initial_condition(u_new.data(), u_old.data(), p);
 
   // DONE: Initialize a exec::static_thread_pool context with 3 threads
   exec::static_thread_pool ctx{3}; 
@@ -137,19 +137,21 @@ int main(int argc, char *argv[]) {
               << memory_bw * p.nranks << " GB/s" << std::endl; 
   }
 
-  // Write output to file
+  // Write output to file: a header with the global extents, the bytes per value and the end time,
+  // followed by the values.
   MPI_File f;
   MPI_File_open(MPI_COMM_WORLD, "output", MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &f);
-  auto header_bytes = 2 * sizeof(long) + sizeof(double);
+  auto header_bytes = 3 * sizeof(long) + sizeof(double);
   auto values_per_rank = p.nx * p.ny;
   auto values_bytes_per_rank = values_per_rank * sizeof(double);
   MPI_File_set_size(f, header_bytes + values_bytes_per_rank * p.nranks);
   MPI_Request req[3] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  // The header must outlive the non-blocking writes, which complete in MPI_Waitall:
+  long total[3] = {p.nx * p.nranks, p.ny, sizeof(double)};
+  double end_time = p.nit() * p.dt;
   if (p.rank == 0) {
-    long total[2] = {p.nx * p.nranks, p.ny};
-    double time = p.nit() * p.dt;
-    MPI_File_iwrite_at(f, 0, total, 2, MPI_UINT64_T, &req[1]);
-    MPI_File_iwrite_at(f, 2 * sizeof(long), &time, 1, MPI_DOUBLE, &req[2]);
+    MPI_File_iwrite_at(f, 0, total, 3, MPI_UINT64_T, &req[1]);
+    MPI_File_iwrite_at(f, 3 * sizeof(long), &end_time, 1, MPI_DOUBLE, &req[2]);
   }
   auto values_offset = header_bytes + p.rank * values_bytes_per_rank;
   MPI_File_iwrite_at(f, values_offset, u_old.data() + p.ny, values_per_rank, MPI_DOUBLE, &req[0]);
@@ -189,21 +191,6 @@ double stencil(double *u_new, double *u_old, long x, long y, parameters p) {
       assert(y >= 0 && y < p.ny);
       return x * p.ny + y;
   };
-  // Apply boundary conditions:
-  if (y == 1) {
-    u_old[idx(x, y - 1)] = 0;
-  }
-  if (y == (p.ny - 2)) {
-    u_old[idx(x, y + 1)] = 0;
-  }
-  // These boundary conditions are only impossed by the ranks at the end of the domain:
-  if (p.rank == 0 && x == 1) {
-    u_old[idx(x - 1, y)] = 1;
-  }
-  if (p.rank == (p.nranks - 1) && x == p.nx) {
-    u_old[idx(x + 1, y)] = 0;
-  }
-
   u_new[idx(x, y)] = (1. - 4. * p.gamma()) * u_old[idx(x, y)] +
                      p.gamma() * (u_old[idx(x + 1, y)] + u_old[idx(x - 1, y)] +
                                   u_old[idx(x, y + 1)] + u_old[idx(x, y - 1)]);
@@ -223,10 +210,28 @@ double apply_stencil(double* u_new, double* u_old, grid g, parameters p) {
   });
 }
 
+// Boundary conditions, imposed on the cells around the domain that the stencil reads but never
+// writes. This keeps the branches and the stores to "u_old" out of the stencil.
+void boundary_conditions(double* u, parameters p) {
+  std::for_each_n(std::execution::par, std::views::iota(1L).begin(), p.nx, [u, p](long x) {
+    u[x * p.ny] = 0;
+    u[x * p.ny + p.ny - 1] = 0;
+  });
+  // These boundary conditions are only imposed by the ranks at the end of the domain:
+  std::for_each_n(std::execution::par, std::views::iota(1L).begin(), p.ny - 2, [u, p](long y) {
+    if (p.rank == 0) u[y] = 1;
+    if (p.rank == (p.nranks - 1)) u[(p.nx + 1) * p.ny + y] = 0;
+  });
+}
+
 // Initial condition
-void initial_condition(double* u_new, double* u_old, long n) {
-  std::fill_n(std::execution::par, u_old, n, 0.0);
-  std::fill_n(std::execution::par, u_new, n, 0.0);
+void initial_condition(double* u_new, double* u_old, parameters p) {
+  std::fill_n(std::execution::par, u_old, p.n(), 0.0);
+  std::fill_n(std::execution::par, u_new, p.n(), 0.0);
+  // The stencil never writes the boundary cells, so imposing the boundary conditions once on
+  // both grids keeps them for all time steps:
+  boundary_conditions(u_old, p);
+  boundary_conditions(u_new, p);
 }
 
 // Evolve the solution of the interior part of the domain
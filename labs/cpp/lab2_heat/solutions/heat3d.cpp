@@ -0,0 +1,267 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Solves heat equation in 3D with a 7-point stencil, decomposed along "x" across MPI ranks.
+//!
+//! The stencil is applied over std::views::cartesian_product of three iota ranges, which
+//! <cartesian_product.hpp> specializes into a single cursor over the 3D index space. Compile with
+//! -DDISABLE_CART_PROD_IOTA_SPEC to compare against the generic cartesian_product.
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <mdspan>
+#include <mpi.h>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+#include <cartesian_product.hpp> // Brings C++23 std::views::cartesian_product to C++20
+
+using grid_t = std::mdspan<double, std::dextents<std::size_t, 3>, std::layout_right>;
+
+// Problem parameters
+struct parameters {
+  double dx, dt;
+  long nx, ny, nz, ni;
+  int rank = 0, nranks = 1;
+
+  static constexpr double alpha() { return 1.0; } // Thermal diffusivity
+
+  parameters(int argc, char *argv[]);
+
+  long nit() { return ni; }
+  long nout() { return 1000; }
+  long nx_global() { return nx * nranks; }
+  long ny_global() { return ny; }
+  long nz_global() { return nz; }
+  double gamma() { return alpha() * dt / (dx * dx); }
+  long n() { return ny * nz * (nx + 2 /* 2 halo layers */); }
+};
+
+// 3D grid of indices
+struct grid {
+  long x_begin, x_end, y_begin, y_end, z_begin, z_end;
+};
+
+// Finite-difference stencil
+double stencil(grid_t u_new, grid_t u_old, long x, long y, long z, parameters p) {
+  u_new(x, y, z) = (1. - 6. * p.gamma()) * u_old(x, y, z) +
+                   p.gamma() * (u_old(x + 1, y, z) + u_old(x - 1, y, z) +
+                                u_old(x, y + 1, z) + u_old(x, y - 1, z) +
+                                u_old(x, y, z + 1) + u_old(x, y, z - 1));
+  return u_new(x, y, z) * p.dx * p.dx * p.dx;
+}
+
+double apply_stencil(grid_t u_new, grid_t u_old, grid g, parameters p) {
+  auto xs = std::views::iota(g.x_begin, g.x_end);
+  auto ys = std::views::iota(g.y_begin, g.y_end);
+  auto zs = std::views::iota(g.z_begin, g.z_end);
+  auto ids = std::views::cartesian_product(xs, ys, zs);
+  return std::transform_reduce(std::execution::par, ids.begin(), ids.end(), 0., std::plus{},
+                               [u_new, u_old, p](auto idx) {
+    auto [x, y, z] = idx;
+    return stencil(u_new, u_old, x, y, z, p);
+  });
+}
+
+// Boundary conditions, imposed on the cells around the domain that the stencil reads but never
+// writes.
+void boundary_conditions(grid_t u, parameters p) {
+  auto xs = std::views::iota(1L, p.nx + 1);
+  auto ys = std::views::iota(0L, p.ny);
+  auto zs = std::views::iota(0L, p.nz);
+  auto xy = std::views::cartesian_product(xs, ys);
+  std::for_each(std::execution::par, xy.begin(), xy.end(), [u, p](auto idx) {
+    auto [x, y] = idx;
+    u(x, y, 0) = 0;
+    u(x, y, p.nz - 1) = 0;
+  });
+  auto xz = std::views::cartesian_product(xs, zs);
+  std::for_each(std::execution::par, xz.begin(), xz.end(), [u, p](auto idx) {
+    auto [x, z] = idx;
+    u(x, 0, z) = 0;
+    u(x, p.ny - 1, z) = 0;
+  });
+  // These boundary conditions are only imposed by the ranks at the end of the domain:
+  auto yz = std::views::cartesian_product(std::views::iota(1L, p.ny - 1),
+                                          std::views::iota(1L, p.nz - 1));
+  std::for_each(std::execution::par, yz.begin(), yz.end(), [u, p](auto idx) {
+    auto [y, z] = idx;
+    if (p.rank == 0) u(0, y, z) = 1;
+    if (p.rank == (p.nranks - 1)) u(p.nx + 1, y, z) = 0;
+  });
+}
+
+// Initial condition
+void initial_condition(grid_t u_new, grid_t u_old, parameters p) {
+  std::fill_n(std::execution::par, u_old.data_handle(), u_old.size(), 0.0);
+  std::fill_n(std::execution::par, u_new.data_handle(), u_new.size(), 0.0);
+  boundary_conditions(u_old, p);
+  boundary_conditions(u_new, p);
+}
+
+// These evolve the solution of different parts of the local domain.
+double inner(grid_t u_new, grid_t u_old, parameters p);
+double prev (grid_t u_new, grid_t u_old, parameters p);
+double next (grid_t u_new, grid_t u_old, parameters p);
+
+int main(int argc, char *argv[]) {
+  // Parse CLI parameters
+  parameters p(argc, argv);
+
+  // Initialize MPI with multi-threading support
+  int mt;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mt);
+  if (mt != MPI_THREAD_MULTIPLE) {
+    std::cerr << "MPI cannot be called from multiple host threads" << std::endl;
+    std::terminate();
+  }
+  MPI_Comm_size(MPI_COMM_WORLD, &p.nranks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &p.rank);
+
+  // Allocate memory
+  std::vector<double> u_new_data(p.n()), u_old_data(p.n());
+  grid_t u_new{u_new_data.data(), p.nx + 2, p.ny, p.nz};
+  grid_t u_old{u_old_data.data(), p.nx + 2, p.ny, p.nz};
+
+  // Initial condition
+  initial_condition(u_new, u_old, p);
+
+  // Time loop
+  using clk_t = std::chrono::steady_clock;
+  auto start = clk_t::now();
+
+  for (long it = 0; it < p.nit(); ++it) {
+    // Evolve the solution:
+    double energy = prev(u_new, u_old, p) + next(u_new, u_old, p) + inner(u_new, u_old, p);
+
+    // Reduce the energy across all neighbors to the rank == 0, and print it if necessary:
+    MPI_Reduce(p.rank == 0 ? MPI_IN_PLACE : &energy, &energy, 1, MPI_DOUBLE, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+    if (p.rank == 0 && it % p.nout() == 0) {
+      std::cerr << "E(t=" << it * p.dt << ") = " << energy << std::endl;
+    }
+    std::swap(u_new, u_old);
+  }
+
+  auto time = std::chrono::duration<double>(clk_t::now() - start).count();
+  auto grid_size = static_cast<double>(p.nx * p.ny * p.nz * sizeof(double) * 2) * 1e-9; // GB
+  auto memory_bw = grid_size * static_cast<double>(p.nit()) / time;                    // GB/s
+
+  // STREAM-like ceiling: each time step reads one grid and writes the other, like a copy.
+  auto copy_data = std::vector<double>(u_old_data);
+  auto copy_start = clk_t::now();
+  for (int i = 0; i < 10; ++i) {
+    std::copy(std::execution::par, u_old_data.begin(), u_old_data.end(), copy_data.begin());
+  }
+  auto copy_bw = static_cast<double>(u_old_data.size() * sizeof(double) * 2) * 1e-9 * 10. /
+                 std::chrono::duration<double>(clk_t::now() - copy_start).count();
+  if (p.rank == 0) {
+    std::cerr << "Rank " << p.rank << ": local domain " << p.nx << "x" << p.ny << "x" << p.nz
+              << " (" << grid_size << " GB): " << memory_bw << " GB/s ("
+              << 100. * memory_bw / copy_bw << "% of the " << copy_bw << " GB/s copy bandwidth)"
+              << std::endl;
+    std::cerr << "All ranks: global domain " << p.nx_global() << "x" << p.ny_global() << "x"
+              << p.nz_global() << " (" << (grid_size * p.nranks) << " GB): "
+              << memory_bw * p.nranks << " GB/s" << std::endl;
+  }
+
+  // Write output to file: a header with the global extents and the end time, followed by the
+  // values in "x"-major order. The planes owned by each rank are contiguous in its grid and in the
+  // file.
+  MPI_File f;
+  MPI_File_open(MPI_COMM_WORLD, "output", MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &f);
+  auto header_bytes = 3 * sizeof(long) + sizeof(double);
+  auto values_per_rank = p.nx * p.ny * p.nz;
+  auto values_bytes_per_rank = values_per_rank * sizeof(double);
+  MPI_File_set_size(f, header_bytes + values_bytes_per_rank * p.nranks);
+  MPI_Request req[3] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  // The header must outlive the non-blocking writes, which complete in MPI_Waitall:
+  long total[3] = {p.nx * p.nranks, p.ny, p.nz};
+  double end_time = p.nit() * p.dt;
+  if (p.rank == 0) {
+    MPI_File_iwrite_at(f, 0, total, 3, MPI_UINT64_T, &req[1]);
+    MPI_File_iwrite_at(f, 3 * sizeof(long), &end_time, 1, MPI_DOUBLE, &req[2]);
+  }
+  auto values_offset = header_bytes + p.rank * values_bytes_per_rank;
+  MPI_File_iwrite_at(f, values_offset, &u_old(1, 0, 0), values_per_rank, MPI_DOUBLE, &req[0]);
+  MPI_Waitall(p.rank == 0 ? 3 : 1, req, MPI_STATUSES_IGNORE);
+  MPI_File_close(&f);
+
+  MPI_Finalize();
+  return 0;
+}
+
+// Reads command line arguments to initialize problem size
+parameters::parameters(int argc, char *argv[]) {
+  if (argc != 5) {
+    std::cerr << "ERROR: incorrect arguments" << std::endl;
+    std::cerr << "  " << argv[0] << " <nx> <ny> <nz> <ni>" << std::endl;
+    std::terminate();
+  }
+  nx = std::stoll(argv[1]);
+  ny = std::stoll(argv[2]);
+  nz = std::stoll(argv[3]);
+  ni = std::stoll(argv[4]);
+  dx = 1.0 / nx;
+  dt = dx * dx / (7. * alpha());
+}
+
+// Evolve the solution of the interior part of the domain
+// which does not depend on data from neighboring ranks
+double inner(grid_t u_new, grid_t u_old, parameters p) {
+  grid g{.x_begin = 2, .x_end = p.nx, .y_begin = 1, .y_end = p.ny - 1,
+         .z_begin = 1, .z_end = p.nz - 1};
+  return apply_stencil(u_new, u_old, g, p);
+}
+
+// Evolve the solution of the part of the domain that
+// depends on data from the previous MPI rank (rank - 1)
+double prev(grid_t u_new, grid_t u_old, parameters p) {
+  // The "x" planes are contiguous, so the halos are sent and received in place:
+  int count = (int)(p.ny * p.nz);
+  if (p.rank > 0) {
+    MPI_Sendrecv(&u_old(1, 0, 0), count, MPI_DOUBLE, p.rank - 1, 0,
+                 &u_old(0, 0, 0), count, MPI_DOUBLE, p.rank - 1, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+  grid g{.x_begin = 1, .x_end = 2, .y_begin = 1, .y_end = p.ny - 1,
+         .z_begin = 1, .z_end = p.nz - 1};
+  return apply_stencil(u_new, u_old, g, p);
+}
+
+// Evolve the solution of the part of the domain that
+// depends on data from the next MPI rank (rank + 1)
+double next(grid_t u_new, grid_t u_old, parameters p) {
+  int count = (int)(p.ny * p.nz);
+  if (p.rank < p.nranks - 1) {
+    MPI_Sendrecv(&u_old(p.nx, 0, 0), count, MPI_DOUBLE, p.rank + 1, 0,
+                 &u_old(p.nx + 1, 0, 0), count, MPI_DOUBLE, p.rank + 1, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+  grid g{.x_begin = p.nx, .x_end = p.nx + 1, .y_begin = 1, .y_end = p.ny - 1,
+         .z_begin = 1, .z_end = p.nz - 1};
+  return apply_stencil(u_new, u_old, g, p);
+}
@@ -0,0 +1,823 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Solves heat equation in 2D like the Exercise 1 solution, with the optimizations of the heat lab:
+//! an explicit SIMD row kernel, cache-blocked tiles and a tile-size sweep, temporal blocking,
+//! single and mixed precision, an in-place update with rolling row buffers, and padded rows.
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <fstream>
+#include <iostream>
+#include <mdspan>
+#include <mpi.h>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Explicit SIMD for the row kernel on CPUs; GPU kernels are already vectorized across threads.
+#if __has_include(<experimental/simd>) && !defined(_NVHPC_STDPAR_GPU)
+#include <experimental/simd>
+#define HEAT_SIMD
+#endif
+
+// Returns x * y + z, fused on targets with FMA instructions. Elsewhere fma is a libm call per
+// element, which is far slower than a multiply and an add.
+template <class V>
+V madd(V x, V y, V z) {
+#if defined(__FMA__) || defined(__NVCOMPILER)
+  using std::fma; // Scalars; SIMD vectors find their fma by ADL
+  return fma(x, y, z);
+#else
+  return x * y + z;
+#endif
+}
+
+// Grids store the values in "T": double, or float for visualization-grade runs that move half the
+// bytes. The energies are accumulated in a separate type "Acc".
+//
+// Rows are contiguous, but consecutive rows are p.ld >= p.ny values apart: the padding keeps rows
+// whose size is a multiple of 4 KiB from mapping to the same cache sets.
+template <class T>
+using grid_t = std::mdspan<T, std::dextents<std::size_t, 2>, std::layout_stride>;
+
+// MPI datatype of "T"
+template <class T>
+MPI_Datatype mpi_type() {
+  static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>);
+  return std::is_same_v<T, double> ? MPI_DOUBLE : MPI_FLOAT;
+}
+
+// Problem parameters
+struct parameters {
+  double dx, dt;
+  long nx, ny, ni;
+  int rank = 0, nranks = 1;
+  long tile_x = 0, tile_y = 0; // Tile size of the stencil, or 0 to process whole rows
+  bool sweep = false;           // Search the fastest tile size before the time loop
+  long tile_t = 1;              // Time steps per tile with temporal blocking
+  std::string precision = "double"; // Storage/accumulation: "double", "single" or "mixed"
+  bool in_place = false;            // Update a single grid in place, see "step_in_place"
+  bool pad = true;                  // Pad the rows of the grids, see "padded_ld"
+  bool compare = false;             // Compare the final energy against a double precision run
+  long ld = 0;                      // Leading dimension: values from one row to the next
+
+  static constexpr double alpha() { return 1.0; } // Thermal diffusivity
+
+  parameters(int argc, char *argv[]);
+
+  long nit() { return ni; }
+  long nout() { return 1000; }
+  long nx_global() { return nx * nranks; }
+  long ny_global() { return ny; }
+  double gamma() { return alpha() * dt / (dx * dx); }
+  long n() { return ld * (nx + 2 /* 2 halo layers */); }
+};
+
+// Leading dimension of grids of "T": "ny" rounded up to whole cache lines, plus one cache line if
+// the rows are then a multiple of 4 KiB, so that the rows x - 1, x and x + 1 start in different
+// cache sets.
+template <class T>
+long padded_ld(long ny) {
+  constexpr long line = 64 / sizeof(T), page = 4096 / sizeof(T);
+  auto ld = (ny + line - 1) / line * line;
+  if (ld % page == 0) ld += line;
+  return ld;
+}
+
+// Grid of (nx + 2) x ny values over "data", with rows p.ld values apart.
+template <class T>
+grid_t<T> make_grid(T* data, parameters p);
+
+// MPI datatype of "rows" consecutive rows of a grid of "T", without their padding. Free it with
+// MPI_Type_free.
+template <class T>
+MPI_Datatype mpi_rows_type(long rows, parameters p);
+
+template <class Acc, class Grid>
+Acc stencil(Grid u_new, Grid u_old, long x, long y, parameters p);
+
+template <class Acc, class T>
+Acc stencil_row(T* u_new, const T* u_old, const T* u_prev, const T* u_next, long y_begin,
+                long y_end, parameters p);
+
+// 2D grid of indicies
+struct grid {
+  long x_begin, x_end, y_begin, y_end;
+};
+
+// Applies the stencil row by row: parallelizes over "x" and processes each row [g.y_begin, g.y_end),
+// which is contiguous in memory, with "stencil_row".
+template <class Acc, class T>
+Acc apply_stencil_rows(grid_t<T> u_new, grid_t<T> u_old, grid g, parameters p) {
+  auto xs = std::views::iota(g.x_begin, g.x_end);
+  return std::transform_reduce(std::execution::par, xs.begin(), xs.end(), Acc{0}, std::plus{},
+                               [u_new, u_old, g, p](long x) {
+    return stencil_row<Acc>(&u_new(x, 0), &u_old(x, 0), &u_old(x - 1, 0), &u_old(x + 1, 0),
+                       g.y_begin, g.y_end, p);
+  });
+}
+
+// Applies the stencil tile by tile: parallelizes over tiles of p.tile_x rows by p.tile_y columns,
+// and sweeps each tile row-wise, so that the rows x - 1, x and x + 1 of a tile stay in cache
+// between their uses.
+template <class Acc, class T>
+Acc apply_stencil_tiles(grid_t<T> u_new, grid_t<T> u_old, grid g, parameters p) {
+  auto ntx = (g.x_end - g.x_begin + p.tile_x - 1) / p.tile_x;
+  auto nty = (g.y_end - g.y_begin + p.tile_y - 1) / p.tile_y;
+  auto tiles = std::views::iota(0L, ntx * nty);
+  return std::transform_reduce(std::execution::par, tiles.begin(), tiles.end(), Acc{0}, std::plus{},
+                               [u_new, u_old, g, p, nty](long t) {
+    auto x_begin = g.x_begin + (t / nty) * p.tile_x, x_end = std::min(x_begin + p.tile_x, g.x_end);
+    auto y_begin = g.y_begin + (t % nty) * p.tile_y, y_end = std::min(y_begin + p.tile_y, g.y_end);
+    Acc energy = 0;
+    for (auto x = x_begin; x < x_end; ++x) {
+      energy += stencil_row<Acc>(&u_new(x, 0), &u_old(x, 0), &u_old(x - 1, 0), &u_old(x + 1, 0),
+                            y_begin, y_end, p);
+    }
+    return energy;
+  });
+}
+
+template <class Acc, class Grid>
+Acc apply_stencil(Grid u_new, Grid u_old, grid g, parameters p) {
+  // Rows are contiguous with layout_right, and with layout_stride if the stride along "y" is 1.
+  // Use the row or tile kernels:
+  if constexpr (std::is_same_v<typename Grid::layout_type, std::layout_right> ||
+                std::is_same_v<typename Grid::layout_type, std::layout_stride>) {
+    if (u_new.stride(1) == 1 && u_old.stride(1) == 1) {
+      if (p.tile_x > 0 && p.tile_y > 0) return apply_stencil_tiles<Acc>(u_new, u_old, g, p);
+      return apply_stencil_rows<Acc>(u_new, u_old, g, p);
+    }
+  }
+  // DONE Create one iota range per dimension for [g.x_begin,g.x_end) and [g.y_begin,g.y_end).
+  auto xs = std::views::iota(g.x_begin, g.x_end);
+  auto ys = std::views::iota(g.y_begin, g.y_end);
+  // DONE: Construct a cartesian_product range from the two iota ranges: [g.x_begin,g.x_end)x[g.y_begin,g.y_end).
+  auto ids = std::views::cartesian_product(xs, ys);
+  // DONE: Use the std::transform_reduce algorithm to apply the stencil in parallel to each element and sum the energies:
+  return std::transform_reduce(
+    // DONE: Use the std::execution::par parallel execution policy
+    std::execution::par,
+    // DONE: iterate over the cartesian_product range
+    ids.begin(), ids.end(),
+    // DONE: initialize the energy to zero
+    Acc{0},
+    // DONE: use std::plus to sum the energies
+    std::plus{},
+    // DONE: Use a lambda that applies the stencil to one element and returns its energy:
+    [u_new, u_old, p](auto idx) {
+      // DONE [within lambda]: Extract the 1D indices from the tuple of indices:
+      auto [x, y] = idx;
+      // DONE [within lambda]: Apply the stencil and return the energy.
+      return stencil<Acc>(u_new, u_old, x, y, p);
+  });
+}
+
+// Boundary conditions
+template <class T>
+void boundary_conditions(grid_t<T> u, parameters p);
+
+// Initial condition
+template <class T>
+void initial_condition(grid_t<T> u_new, grid_t<T> u_old, parameters p) {
+  // DONE: parallelize using the std::fill_n parallel algorithm
+  std::fill_n(std::execution::par, u_old.data_handle(), u_old.mapping().required_span_size(), 0.0);
+  std::fill_n(std::execution::par, u_new.data_handle(), u_new.mapping().required_span_size(), 0.0);
+  // The stencil never writes the boundary cells, so imposing the boundary conditions once on
+  // both grids keeps them for all time steps:
+  boundary_conditions(u_old, p);
+  boundary_conditions(u_new, p);
+}
+
+// These evolve the solution of different parts of the local domain.
+template <class Acc, class T> Acc inner(grid_t<T> u_new, grid_t<T> u_old, parameters p);
+template <class Acc, class T> Acc prev (grid_t<T> u_new, grid_t<T> u_old, parameters p);
+template <class Acc, class T> Acc next (grid_t<T> u_new, grid_t<T> u_old, parameters p);
+
+// Sets p.tile_x and p.tile_y to the tile size for which "inner" is the fastest on all ranks.
+template <class Acc, class T>
+void sweep_tiles(grid_t<T> u_new, grid_t<T> u_old, parameters& p);
+
+// Energies of the time steps advanced at once with temporal blocking.
+constexpr long max_tile_t = 16;
+template <class Acc>
+using energies_t = std::array<Acc, max_tile_t>;
+
+#ifndef _NVHPC_STDPAR_GPU
+// Advances the solution by "steps" time steps from "u_old" to "u_new", and returns the energy of
+// each step. Its scratch buffers are per CPU thread, so it is not compiled for GPUs.
+template <class Acc, class T>
+energies_t<Acc> temporal_block(grid_t<T> u_new, grid_t<T> u_old, parameters p, long steps);
+#endif
+
+#ifndef _NVHPC_STDPAR_GPU
+// Advances the solution in "u" by one time step in place, and returns its energy. Its row buffers
+// are per CPU thread, so it is not compiled for GPUs.
+template <class Acc, class T>
+Acc step_in_place(grid_t<T> u, parameters p);
+
+// Rows per chunk of the in-place update, and bytes of the row buffers it uses.
+long in_place_rows(parameters p);
+long in_place_buffer_bytes(parameters p, std::size_t value_size);
+#endif
+
+// Solves the problem with values stored in "T" and energies accumulated in "Acc", and returns the
+// energy of the last time step on rank 0. Reference runs neither print nor write the output.
+template <class T, class Acc>
+double solve(parameters p, bool reference = false);
+
+int main(int argc, char *argv[]) {
+  // Parse CLI parameters
+  parameters p(argc, argv);
+
+  // Initialize MPI with multi-threading support
+  int mt;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mt);
+  if (mt != MPI_THREAD_MULTIPLE) {
+    std::cerr << "MPI cannot be called from multiple host threads" << std::endl;
+    std::terminate();
+  }
+  MPI_Comm_size(MPI_COMM_WORLD, &p.nranks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &p.rank);
+
+  if (p.precision == "double") {
+    solve<double, double>(p);
+  } else {
+    // Float grids, with a float ("single") or double ("mixed") energy accumulator, and optionally
+    // the accuracy of the final energy against the double precision solution:
+    auto energy = p.precision == "single" ? solve<float, float>(p) : solve<float, double>(p);
+    if (p.compare) {
+      auto energy_ref = solve<double, double>(p, true);
+      if (p.rank == 0) {
+        std::cerr << "Final energy: " << energy << " (" << p.precision << "), " << energy_ref
+                  << " (double), relative error " << std::abs(energy - energy_ref) / energy_ref
+                  << std::endl;
+      }
+    }
+  }
+
+  MPI_Finalize();
+  return 0;
+}
+
+template <class T, class Acc>
+double solve(parameters p, bool reference) {
+  // Allocate memory. Updating in place needs a single grid:
+  p.ld = p.pad ? padded_ld<T>(p.ny) : p.ny;
+  std::vector<T> u_new_data(p.in_place ? 0 : p.n()), u_old_data(p.n());
+  auto u_old = make_grid(u_old_data.data(), p);
+  auto u_new = p.in_place ? u_old : make_grid(u_new_data.data(), p);
+  auto memory = (u_new_data.size() + u_old_data.size()) * sizeof(T);
+#ifndef _NVHPC_STDPAR_GPU
+  if (p.in_place) memory += in_place_buffer_bytes(p, sizeof(T));
+#endif
+
+  // Initial condition
+  initial_condition(u_new, u_old, p);
+
+  // Tune the tile size, and restore the initial condition overwritten by the sweep:
+  if (p.sweep && !reference) {
+    sweep_tiles<Acc>(u_new, u_old, p);
+    initial_condition(u_new, u_old, p);
+  }
+
+  // Time loop
+  using clk_t = std::chrono::steady_clock;
+  auto start = clk_t::now();
+
+  energies_t<double> energy{};
+  double final_energy = 0.;
+  for (long it = 0; it < p.nit();) {
+    // Evolve the solution by one time step, or by several with temporal blocking:
+    auto steps = std::min(p.tile_t, p.nit() - it);
+#ifndef _NVHPC_STDPAR_GPU
+    if (p.in_place) {
+      energy[0] = step_in_place<Acc>(u_old, p);
+    } else if (steps > 1) {
+      std::ranges::copy(temporal_block<Acc>(u_new, u_old, p, steps), energy.begin());
+    } else
+#endif
+    {
+      energy[0] = prev<Acc>(u_new, u_old, p) + next<Acc>(u_new, u_old, p) +
+                  inner<Acc>(u_new, u_old, p);
+    }
+
+    // Reduce the energy across all neighbors to the rank == 0, and print it if necessary:
+    MPI_Reduce(p.rank == 0 ? MPI_IN_PLACE : energy.data(), energy.data(), (int)steps, MPI_DOUBLE,
+               MPI_SUM, 0, MPI_COMM_WORLD);
+    for (long s = 0; s < steps; ++s) {
+      if (p.rank == 0 && !reference && (it + s) % p.nout() == 0) {
+        std::cerr << "E(t=" << (it + s) * p.dt << ") = " << energy[s] << std::endl;
+      }
+    }
+    if (!p.in_place) std::swap(u_new, u_old);
+    it += steps;
+    final_energy = energy[steps - 1];
+  }
+  if (reference) return final_energy;
+
+  auto time = std::chrono::duration<double>(clk_t::now() - start).count();
+  auto grid_size = static_cast<double>(p.nx * p.ny * sizeof(T) * 2) * 1e-9; // GB
+  auto memory_bw = grid_size * static_cast<double>(p.nit()) / time;        // GB/s
+
+  // Write output to file. The values are stored as "T", whose size is recorded in the header.
+  MPI_File f;
+  MPI_File_open(MPI_COMM_WORLD, "output", MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &f);
+  auto header_bytes = 3 * sizeof(long) + sizeof(double);
+  auto values_per_rank = p.nx * p.ny;
+  auto values_bytes_per_rank = values_per_rank * sizeof(T);
+  MPI_File_set_size(f, header_bytes + values_bytes_per_rank * p.nranks);
+  MPI_Request req[3] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  // The header must outlive the non-blocking writes, which complete in MPI_Waitall:
+  long total[3] = {p.nx * p.nranks, p.ny, sizeof(T)};
+  double end_time = p.nit() * p.dt;
+  if (p.rank == 0) {
+    MPI_File_iwrite_at(f, 0, total, 3, MPI_UINT64_T, &req[1]);
+    MPI_File_iwrite_at(f, 3 * sizeof(long), &end_time, 1, MPI_DOUBLE, &req[2]);
+  }
+  auto values_offset = header_bytes + p.rank * values_bytes_per_rank;
+  // In-place runs write the grid directly, since the copy would need a second grid:
+  auto u_out_data = std::vector<T>(p.in_place ? 0 : (p.nx + 2) * p.ny);
+  using grid_io_t = std::mdspan<T, std::dextents<std::size_t, 2>, std::layout_right>;
+  grid_io_t u_out{u_out_data.data(), p.nx+2, p.ny};
+  auto is = std::views::iota(0, (int)u_out.extent(0));
+  auto js = std::views::iota(0, (int)u_out.extent(1));
+  auto ids = std::views::cartesian_product(is, js);
+  if (!p.in_place) {
+    std::for_each(std::execution::par, ids.begin(), ids.end(), [u_out, u_old](auto idx) {
+       auto [i, j] = idx;
+       u_out(i, j) = u_old(i, j);
+    });
+  }
+  // The padding is skipped by writing the rows of the grid with a strided datatype:
+  auto rows_type = mpi_rows_type<T>(p.nx, p);
+  if (p.in_place) {
+    MPI_File_iwrite_at(f, values_offset, &u_old(1, 0), 1, rows_type, &req[0]);
+  } else {
+    MPI_File_iwrite_at(f, values_offset, u_out.data_handle() + p.ny, values_per_rank,
+                       mpi_type<T>(), &req[0]);
+  }
+  MPI_Waitall(p.rank == 0 ? 3 : 1, req, MPI_STATUSES_IGNORE);
+  MPI_Type_free(&rows_type);
+  MPI_File_close(&f);
+
+  // STREAM-like ceiling: each time step reads one grid and writes the other, like a copy. Once the
+  // output is written, it is measured by copying the first half of the grid onto the second half,
+  // which needs no memory beyond the grids.
+  auto half = u_old_data.size() / 2;
+  auto copy_start = clk_t::now();
+  for (int i = 0; i < 10; ++i) {
+    std::copy(std::execution::par, u_old_data.begin(), u_old_data.begin() + half,
+              u_old_data.begin() + half);
+  }
+  auto copy_bw = static_cast<double>(half * sizeof(T) * 2) * 1e-9 * 10. /
+                 std::chrono::duration<double>(clk_t::now() - copy_start).count();
+  if (p.rank == 0) {
+    std::cerr << "Rank " << p.rank << ": local domain " << p.nx << "x" << p.ny << " (" << grid_size << " GB): " 
+              << memory_bw << " GB/s (" << 100. * memory_bw / copy_bw << "% of the " << copy_bw
+              << " GB/s copy bandwidth), " << memory * 1e-9 << " GB of grids and buffers"
+              << (p.in_place ? " (in place)" : "") << std::endl;
+    std::cerr << "All ranks: global domain " << p.nx_global() << "x" << p.ny_global() << " (" << (grid_size * p.nranks) << " GB): "
+              << memory_bw * p.nranks << " GB/s" << std::endl;
+  }
+
+
+  return final_energy;
+}
+
+// Times "inner" for tiles of 1 to 64 rows by 256 columns to whole rows, and keeps the fastest.
+// The slowest rank decides the time of each tile size, so that all ranks pick the same one.
+template <class Acc, class T>
+void sweep_tiles(grid_t<T> u_new, grid_t<T> u_old, parameters& p) {
+  using clk_t = std::chrono::steady_clock;
+  std::vector<std::pair<long, long>> tiles;
+  for (long tx : {1, 4, 16, 64}) {
+    for (long ty = 256; ty < p.ny; ty *= 4) tiles.emplace_back(tx, ty);
+    tiles.emplace_back(tx, p.ny);
+  }
+  std::vector<double> times(tiles.size());
+  for (std::size_t i = 0; i < tiles.size(); ++i) {
+    std::tie(p.tile_x, p.tile_y) = tiles[i];
+    inner<Acc>(u_new, u_old, p);
+    auto start = clk_t::now();
+    for (int it = 0; it < 5; ++it) inner<Acc>(u_new, u_old, p);
+    times[i] = std::chrono::duration<double>(clk_t::now() - start).count() / 5;
+  }
+  MPI_Allreduce(MPI_IN_PLACE, times.data(), (int)times.size(), MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  auto best = std::min_element(times.begin(), times.end()) - times.begin();
+  std::tie(p.tile_x, p.tile_y) = tiles[best];
+  if (p.rank == 0) {
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+      std::cerr << "Tile " << tiles[i].first << "x" << tiles[i].second << ": " << times[i] << " s" << std::endl;
+    }
+    std::cerr << "Best tile: " << p.tile_x << "x" << p.tile_y << std::endl;
+  }
+}
+
+#ifndef _NVHPC_STDPAR_GPU
+// Temporal blocking with overlapped tiles: each tile of p.tile_x by p.tile_y cells is loaded
+// together with "steps" cells of its neighbors on each side, and advanced "steps" time steps in a scratch
+// buffer that stays in cache. The valid region shrinks by one cell per step on the sides that are
+// not physical boundaries, so that after the last step it still covers the tile, which is written
+// to "u_new". Only the cells of the tile contribute to the energies.
+//
+// At the MPI boundaries, "steps" rows are exchanged with each neighbor before the block, so that
+// tiles next to them compute the neighbor's contribution redundantly instead of exchanging every
+// step.
+template <class Acc, class T>
+energies_t<Acc> temporal_block(grid_t<T> u_new, grid_t<T> u_old, parameters p, long steps) {
+  // Deep halo exchange: rows [1 - steps, 0] come from the previous rank, [nx + 1, nx + steps] from
+  // the next rank.
+  thread_local std::vector<T> halo_prev, halo_next;
+  halo_prev.resize(steps * p.ny);
+  halo_next.resize(steps * p.ny);
+  bool has_prev = p.rank > 0, has_next = p.rank < p.nranks - 1;
+  MPI_Request req[4] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  // The rows are sent without their padding, and received contiguously:
+  int count = (int)(steps * p.ny);
+  auto rows_type = mpi_rows_type<T>(steps, p);
+  if (has_prev) {
+    MPI_Irecv(halo_prev.data(), count, mpi_type<T>(), p.rank - 1, 0, MPI_COMM_WORLD, &req[0]);
+    MPI_Isend(&u_old(1, 0), 1, rows_type, p.rank - 1, 1, MPI_COMM_WORLD, &req[1]);
+  }
+  if (has_next) {
+    MPI_Irecv(halo_next.data(), count, mpi_type<T>(), p.rank + 1, 1, MPI_COMM_WORLD, &req[2]);
+    MPI_Isend(&u_old(p.nx - steps + 1, 0), 1, rows_type, p.rank + 1, 0, MPI_COMM_WORLD, &req[3]);
+  }
+  MPI_Waitall(4, req, MPI_STATUSES_IGNORE);
+  MPI_Type_free(&rows_type);
+
+  // Row "x" of the input, for x in [1 - steps, nx + steps]:
+  auto row = [u_old, p, steps, prev = halo_prev.data(), next = halo_next.data(), has_prev,
+              has_next](long x) -> const T* {
+    if (x <= 0 && has_prev) return prev + (x + steps - 1) * p.ny;
+    if (x > p.nx && has_next) return next + (x - p.nx - 1) * p.ny;
+    return &u_old(x, 0);
+  };
+
+  // Without a tile size, tiles span whole rows and are 8 * steps rows tall, so that the 2 * steps
+  // rows computed redundantly around each tile add at most a quarter to its work:
+  auto tile_x = p.tile_x > 0 ? p.tile_x : std::min(8 * steps, p.nx);
+  auto tile_y = p.tile_y > 0 ? p.tile_y : p.ny - 2;
+  auto ntx = (p.nx + tile_x - 1) / tile_x, nty = (p.ny - 2 + tile_y - 1) / tile_y;
+  auto tiles = std::views::iota(0L, ntx * nty);
+  return std::transform_reduce(
+    std::execution::par, tiles.begin(), tiles.end(), energies_t<Acc>{},
+    [](energies_t<Acc> a, energies_t<Acc> const& b) {
+      for (long s = 0; s < max_tile_t; ++s) a[s] += b[s];
+      return a;
+    },
+    [u_new, p, steps, row, tile_x, tile_y, nty, has_prev, has_next](long t) {
+      // Tile [x0, x1) x [y0, y1), extended to [xa, xb) x [ya, yb). The extended region stops at
+      // the physical boundaries, whose values do not change:
+      auto x0 = 1 + (t / nty) * tile_x, x1 = std::min(x0 + tile_x, p.nx + 1);
+      auto y0 = 1 + (t % nty) * tile_y, y1 = std::min(y0 + tile_y, p.ny - 1);
+      auto xa = has_prev ? x0 - steps : std::max(x0 - steps, 0L);
+      auto xb = has_next ? x1 + steps : std::min(x1 + steps, p.nx + 2);
+      auto ya = std::max(y0 - steps, 0L), yb = std::min(y1 + steps, p.ny);
+      bool xa_fixed = !has_prev && xa == 0, xb_fixed = !has_next && xb == p.nx + 2;
+      bool ya_fixed = ya == 0, yb_fixed = yb == p.ny;
+
+      // Two scratch grids of (xb - xa) x (yb - ya) cells, both holding the input:
+      auto ny = yb - ya;
+      thread_local std::vector<T> scratch;
+      scratch.resize(2 * (xb - xa) * ny);
+      T* a = scratch.data();
+      T* b = a + (xb - xa) * ny;
+      for (auto x = xa; x < xb; ++x) {
+        std::copy(row(x) + ya, row(x) + yb, a + (x - xa) * ny);
+        std::copy(row(x) + ya, row(x) + yb, b + (x - xa) * ny);
+      }
+
+      energies_t<Acc> energy{};
+      for (long s = 0; s < steps; ++s) {
+        // Cells still valid after this step:
+        auto xlo = xa + 1 + (xa_fixed ? 0 : s), xhi = xb - 1 - (xb_fixed ? 0 : s);
+        auto ylo = ya + 1 + (ya_fixed ? 0 : s), yhi = yb - 1 - (yb_fixed ? 0 : s);
+        for (auto x = xlo; x < xhi; ++x) {
+          auto i = (x - xa) * ny;
+          auto out = b + i, in = a + i, in_prev = a + i - ny, in_next = a + i + ny;
+          // Only the cells of the tile count towards the energy:
+          if (x >= x0 && x < x1) {
+            stencil_row<Acc>(out, in, in_prev, in_next, ylo - ya, y0 - ya, p);
+            energy[s] += stencil_row<Acc>(out, in, in_prev, in_next, y0 - ya, y1 - ya, p);
+            stencil_row<Acc>(out, in, in_prev, in_next, y1 - ya, yhi - ya, p);
+          } else {
+            stencil_row<Acc>(out, in, in_prev, in_next, ylo - ya, yhi - ya, p);
+          }
+        }
+        std::swap(a, b);
+      }
+      for (auto x = x0; x < x1; ++x) {
+        std::copy(a + (x - xa) * ny + (y0 - ya), a + (x - xa) * ny + (y1 - ya), &u_new(x, y0));
+      }
+      return energy;
+    });
+}
+#endif
+
+#ifndef _NVHPC_STDPAR_GPU
+// Advances the solution by one time step in place: "u" holds the old values before the step and
+// the new values after it.
+//
+// The rows are split into chunks that are updated in parallel. Each worker sweeps its chunk by
+// increasing "x" and keeps the old values of the rows x - 1 and x in a rolling buffer of two rows,
+// so that it never reads a row it has already updated. The first and last rows of every chunk,
+// which the neighboring chunks read, are saved before the update. The stencil is the one of the
+// two-grid update, so the values are bit-identical to it.
+template <class Acc, class T>
+Acc step_in_place(grid_t<T> u, parameters p) {
+  // Exchange the halos. Rows are contiguous, so they are sent and received in place:
+  int count = (int)p.ny;
+  if (p.rank > 0) {
+    MPI_Sendrecv(&u(1, 0), count, mpi_type<T>(), p.rank - 1, 0,
+                 &u(0, 0), count, mpi_type<T>(), p.rank - 1, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+  if (p.rank < p.nranks - 1) {
+    MPI_Sendrecv(&u(p.nx, 0), count, mpi_type<T>(), p.rank + 1, 0,
+                 &u(p.nx + 1, 0), count, mpi_type<T>(), p.rank + 1, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+
+  // Save the old first and last rows of each chunk:
+  auto rows = in_place_rows(p);
+  auto nchunks = (p.nx + rows - 1) / rows;
+  thread_local std::vector<T> edges;
+  edges.resize(2 * nchunks * p.ny);
+  std::for_each_n(std::execution::par, std::views::iota(0L).begin(), nchunks,
+                  [u, p, rows, e = edges.data()](long c) {
+    auto x0 = 1 + c * rows, x1 = std::min(x0 + rows, p.nx + 1);
+    std::copy_n(&u(x0, 0), p.ny, e + 2 * c * p.ny);
+    std::copy_n(&u(x1 - 1, 0), p.ny, e + (2 * c + 1) * p.ny);
+  });
+
+  auto chunks = std::views::iota(0L, nchunks);
+  return std::transform_reduce(std::execution::par, chunks.begin(), chunks.end(), Acc{0},
+                               std::plus{}, [u, p, rows, nchunks, e = edges.data()](long c) {
+    auto x0 = 1 + c * rows, x1 = std::min(x0 + rows, p.nx + 1);
+    thread_local std::vector<T> buffer;
+    buffer.resize(2 * p.ny);
+    T* row = buffer.data();
+    T* spare = row + p.ny;
+    // Old rows before the chunk, and after it:
+    const T* prev = c > 0 ? e + (2 * c - 1) * p.ny : &u(0, 0);
+    const T* last = c < nchunks - 1 ? e + (2 * c + 2) * p.ny : &u(p.nx + 1, 0);
+    Acc energy = 0;
+    for (auto x = x0; x < x1; ++x) {
+      std::copy_n(&u(x, 0), p.ny, row);
+      const T* next = x + 1 < x1 ? &u(x + 1, 0) : last;
+      energy += stencil_row<Acc>(&u(x, 0), row, prev, next, 1, p.ny - 1, p);
+      prev = row;
+      std::swap(row, spare);
+    }
+    return energy;
+  });
+}
+
+// Chunks of p.tile_x rows if given, otherwise four chunks per thread to balance the load.
+long in_place_rows(parameters p) {
+  if (p.tile_x > 0) return p.tile_x;
+  long nchunks = 4 * std::max(1u, std::thread::hardware_concurrency());
+  return std::max(1L, (p.nx + nchunks - 1) / nchunks);
+}
+
+// Two saved rows per chunk, and a rolling buffer of two rows per thread.
+long in_place_buffer_bytes(parameters p, std::size_t value_size) {
+  auto nchunks = (p.nx + in_place_rows(p) - 1) / in_place_rows(p);
+  long nthreads = std::max(1u, std::thread::hardware_concurrency());
+  return (2 * nchunks + 2 * nthreads) * p.ny * (long)value_size;
+}
+#endif
+
+template <class T>
+grid_t<T> make_grid(T* data, parameters p) {
+  using extents_t = std::dextents<std::size_t, 2>;
+  auto strides = std::array<std::size_t, 2>{(std::size_t)p.ld, 1};
+  auto mapping = std::layout_stride::mapping<extents_t>(extents_t(p.nx + 2, p.ny), strides);
+  return grid_t<T>(data, mapping);
+}
+
+template <class T>
+MPI_Datatype mpi_rows_type(long rows, parameters p) {
+  MPI_Datatype t;
+  MPI_Type_vector((int)rows, (int)p.ny, (int)p.ld, mpi_type<T>(), &t);
+  MPI_Type_commit(&t);
+  return t;
+}
+
+// Reads command line arguments to initialize problem size
+parameters::parameters(int argc, char *argv[]) {
+  // The precision, the comparison, the in-place update and the padding are optional trailing
+  // arguments:
+  for (; argc > 4; --argc) {
+    auto last = std::string(argv[argc - 1]);
+    if (last == "double" || last == "single" || last == "mixed") {
+      precision = last;
+    } else if (last == "compare") {
+      compare = true;
+#ifndef _NVHPC_STDPAR_GPU
+    } else if (last == "inplace") {
+      in_place = true;
+#endif
+    } else if (last == "nopad") {
+      pad = false;
+    } else {
+      break;
+    }
+  }
+#ifdef _NVHPC_STDPAR_GPU
+  // Temporal blocking and the in-place update are not compiled for GPUs, see "temporal_block" and
+  // "step_in_place":
+  constexpr int max_argc = 6;
+  constexpr auto tiles = " [<tile_x> <tile_y> | sweep]";
+  constexpr auto in_place_arg = "";
+#else
+  constexpr int max_argc = 7;
+  constexpr auto tiles = " [<tile_x> <tile_y> [<tile_t>] | sweep]";
+  constexpr auto in_place_arg = " [inplace]";
+#endif
+  if (argc < 4 || argc > max_argc || (argc == 5 && std::string(argv[4]) != "sweep")) {
+    std::cerr << "ERROR: incorrect arguments" << std::endl;
+    std::cerr << "  " << argv[0] << " <nx> <ny> <ni>" << tiles
+              << " [double | single [compare] | mixed [compare]]" << in_place_arg << " [nopad]"
+              << std::endl;
+    std::terminate();
+  }
+  nx = std::stoll(argv[1]);
+  ny = std::stoll(argv[2]);
+  ni = std::stoll(argv[3]);
+  sweep = argc == 5;
+  if (argc >= 6) {
+    tile_x = std::stoll(argv[4]);
+    tile_y = std::stoll(argv[5]);
+  }
+  if (argc == 7) {
+    tile_t = std::stoll(argv[6]);
+    if (tile_t < 1 || tile_t > max_tile_t || tile_t > nx) {
+      std::cerr << "ERROR: <tile_t> must be in [1, min(" << max_tile_t << ", nx)]" << std::endl;
+      std::terminate();
+    }
+  }
+  if (compare && precision == "double") {
+    std::cerr << "ERROR: compare checks single or mixed precision against double" << std::endl;
+    std::terminate();
+  }
+  if (in_place && (sweep || tile_t > 1)) {
+    std::cerr << "ERROR: inplace updates whole rows, one time step at a time" << std::endl;
+    std::terminate();
+  }
+  dx = 1.0 / nx;
+  dt = dx * dx / (5. * alpha());
+}
+
+// Boundary conditions, imposed on the cells around the domain that the stencil reads but never
+// writes. This keeps the branches and the stores to "u_old" out of the stencil.
+template <class T>
+void boundary_conditions(grid_t<T> u, parameters p) {
+  std::for_each_n(std::execution::par, std::views::iota(1L).begin(), p.nx, [u, p](long x) {
+    u(x, 0) = 0;
+    u(x, p.ny - 1) = 0;
+  });
+  // These boundary conditions are only imposed by the ranks at the end of the domain:
+  std::for_each_n(std::execution::par, std::views::iota(1L).begin(), p.ny - 2, [u, p](long y) {
+    if (p.rank == 0) u(0, y) = 1;
+    if (p.rank == (p.nranks - 1)) u(p.nx + 1, y) = 0;
+  });
+}
+
+// Finite-difference stencil
+template <class Acc, class Grid>
+Acc stencil(Grid u_new, Grid u_old, long x, long y, parameters p) {
+  using T = typename Grid::value_type;
+  T a = 1. - 4. * p.gamma(), b = p.gamma();
+  u_new(x, y) = a * u_old(x, y) + b * (u_old(x+1, y) + u_old(x-1, y) + u_old(x, y+1) + u_old(x, y-1));
+
+  return Acc(u_new(x, y)) * Acc(p.dx * p.dx);
+}
+
+// Finite-difference stencil over the cells [y_begin, y_end) of one row, given the row "u_old" and
+// its neighbor rows "u_prev" (x - 1) and "u_next" (x + 1). Returns the energy of the row.
+template <class Acc, class T>
+Acc stencil_row(T* u_new, const T* u_old, const T* u_prev, const T* u_next, long y_begin,
+                long y_end, parameters p) {
+  T a = 1. - 4. * p.gamma(), b = p.gamma();
+  long y = y_begin;
+  Acc energy = 0;
+#ifdef HEAT_SIMD
+  // The neighbors at y - 1 and y + 1 are unaligned loads of the same row:
+  namespace stdx = std::experimental;
+  using simd_t = stdx::native_simd<T>;
+  constexpr long w = simd_t::size();
+  // With a wider accumulator, each vector is converted to "w" lanes of "Acc":
+  using acc_simd_t =
+    std::conditional_t<std::is_same_v<T, Acc>, simd_t, stdx::fixed_size_simd<Acc, w>>;
+  acc_simd_t e = 0;
+  for (; y + w <= y_end; y += w) {
+    simd_t c(u_old + y, stdx::element_aligned), l(u_old + y - 1, stdx::element_aligned),
+           r(u_old + y + 1, stdx::element_aligned), s(u_prev + y, stdx::element_aligned),
+           n(u_next + y, stdx::element_aligned);
+    auto v = madd(simd_t(b), n + s + r + l, a * c);
+    v.copy_to(u_new + y, stdx::element_aligned);
+    e += stdx::static_simd_cast<acc_simd_t>(v);
+  }
+  energy = stdx::reduce(e);
+#endif
+  for (; y < y_end; ++y) {
+    auto v = madd(b, u_next[y] + u_prev[y] + u_old[y + 1] + u_old[y - 1], a * u_old[y]);
+    u_new[y] = v;
+    energy += v;
+  }
+  return energy * Acc(p.dx * p.dx);
+}
+
+// Evolve the solution of the interior part of the domain
+// which does not depend on data from neighboring ranks
+template <class Acc, class T>
+Acc inner(grid_t<T> u_new, grid_t<T> u_old, parameters p) {
+  grid g{.x_begin = 2, .x_end = p.nx, .y_begin = 1, .y_end = p.ny - 1};
+  return apply_stencil<Acc>(u_new, u_old, g, p);
+}
+
+// Evolve the solution of the part of the domain that 
+// depends on data from the previous MPI rank (rank - 1)
+template <class Acc, class T>
+Acc prev(grid_t<T> u_new, grid_t<T> u_old, parameters p) {
+  thread_local std::vector<T> halos_tx((std::size_t)p.ny);
+  thread_local std::vector<T> halos_rx((std::size_t)p.ny);
+  // Send window cells, receive halo cells
+  if (p.rank > 0) {
+    // Copy halos to transmit into the transmit buffer
+    std::for_each_n(std::execution::par, std::views::iota(0).begin(), p.ny, [halos_tx = halos_tx.data(), u_old](int i) {
+       halos_tx[i] = u_old(1, i); 
+    });
+    // Send bottom boundary to bottom rank and receive top boundary from bottom rank
+    MPI_Sendrecv(halos_tx.data(), p.ny, mpi_type<T>(), p.rank - 1, 0, 
+                 halos_rx.data(), p.ny, mpi_type<T>(), p.rank - 1, 0, 
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    // Copy data from the receive buffer into the grid
+    std::for_each_n(std::execution::par, std::views::iota(0).begin(), p.ny, [halos_rx = halos_rx.data(), u_old](int i) {
+       u_old(0, i) = halos_rx[i]; 
+    });
+  }
+  // Compute prev boundary
+  grid g{.x_begin = 1, .x_end = 2, .y_begin= 1, .y_end = p.ny - 1};
+  return apply_stencil<Acc>(u_new, u_old, g, p);
+}
+
+// Evolve the solution of the part of the domain that 
+// depends on data from the next MPI rank (rank + 1)
+template <class Acc, class T>
+Acc next(grid_t<T> u_new, grid_t<T> u_old, parameters p) {
+  // Allocate data for transmitting and receiving halos:
+  thread_local std::vector<T> halos_tx((std::size_t)p.ny);
+  thread_local std::vector<T> halos_rx((std::size_t)p.ny);
+    
+  if (p.rank < p.nranks - 1) {
+    // Copy halos to transmit into the transmit buffer
+    std::for_each_n(std::execution::par, std::views::iota(0).begin(), p.ny, [halos_tx = halos_tx.data(), u_old, p](int i) {
+      halos_tx[i] = u_old(p.nx, i); 
+    });
+    // Receive bottom boundary from top rank and send top boundary to top rank
+    MPI_Sendrecv(halos_tx.data(), p.ny, mpi_type<T>(), p.rank + 1, 0, 
+                 halos_rx.data(), p.ny, mpi_type<T>(), p.rank + 1, 0, 
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    // Copy received halos to the u_old solution buffer
+    std::for_each_n(std::execution::par, std::views::iota(0).begin(), p.ny, [halos_rx = halos_rx.data(), u_old, p](int i) {
+      u_old(p.nx+1, i) = halos_rx[i]; 
+    });
+  }
+  // Compute next boundary
+  grid g{.x_begin = p.nx, .x_end = p.nx + 1, .y_begin = 1, .y_end = p.ny - 1};
+  return apply_stencil<Acc>(u_new, u_old, g, p);
+}
@@ -0,0 +1,278 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//! Solves heat equation in 2D with the 5-, 9- and 13-point Laplacians of <stencil.hpp>: one solver,
+//! templated on the stencil descriptor, whose halo width follows the descriptor, and on the layout
+//! of the grids: row-major, blocked or Morton-ordered (see <layouts.hpp>).
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <mdspan>
+#include <mpi.h>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <layouts.hpp>
+#include <stencil.hpp>
+
+template <class Layout = std::layout_right>
+using grid_t = std::mdspan<double, std::dextents<std::size_t, 2>, Layout>;
+
+// Tiles traversed by the stencil with the blocked and Morton layouts. Tiles aligned to the storage
+// tiles of the blocked layout, and aligned 2^k x 2^k tiles of the Morton layout, are contiguous.
+template <class Layout>
+constexpr std::array<long, 2> tile = {32, 32};
+template <std::size_t BX, std::size_t BY>
+constexpr std::array<long, 2> tile<hpc::layout_blocked<BX, BY>> = {(long)BX, (long)BY};
+
+// Problem parameters. Each rank owns the rows [h, nx + h) of a grid of (nx + 2 h) x ny cells, where
+// h is the halo width of the stencil. The first and last h columns are boundary cells.
+struct parameters {
+  double dx, dt;
+  long nx, ny, ni, h;
+  int rank = 0, nranks = 1;
+
+  static constexpr double alpha() { return 1.0; } // Thermal diffusivity
+
+  parameters(int argc, char *argv[]);
+
+  long nit() { return ni; }
+  long nout() { return 1000; }
+  long nx_global() { return nx * nranks; }
+  long ny_global() { return ny; }
+  double gamma() { return alpha() * dt / (dx * dx); }
+  long n() { return ny * (nx + 2 * h /* 2 halo layers */); }
+};
+
+// 2D grid of indicies
+struct grid {
+  long x_begin, x_end, y_begin, y_end;
+};
+
+// Finite-difference stencil: explicit Euler step of the heat equation with the Laplacian "S".
+template <class S, class Grid>
+double stencil(Grid u_new, Grid u_old, long x, long y, parameters p) {
+  u_new(x, y) = u_old(x, y) + p.gamma() * hpc::stencil_sum<S>(u_old, x, y);
+  return u_new(x, y) * p.dx * p.dx;
+}
+
+template <class S, class Grid>
+double apply_stencil(Grid u_new, Grid u_old, grid g, parameters p) {
+  if constexpr (std::is_same_v<typename Grid::layout_type, std::layout_right>) {
+    auto xs = std::views::iota(g.x_begin, g.x_end);
+    auto ys = std::views::iota(g.y_begin, g.y_end);
+    auto ids = std::views::cartesian_product(xs, ys);
+    return std::transform_reduce(std::execution::par, ids.begin(), ids.end(), 0., std::plus{},
+                                 [u_new, u_old, p](auto idx) {
+      auto [x, y] = idx;
+      return stencil<S>(u_new, u_old, x, y, p);
+    });
+  } else {
+    // Traverse the grid tile by tile, so that each task updates a contiguous block of memory:
+    using layout_t = typename Grid::layout_type;
+    constexpr auto tx = tile<layout_t>[0], ty = tile<layout_t>[1];
+    auto txs = std::views::iota(g.x_begin / tx, (g.x_end + tx - 1) / tx);
+    auto tys = std::views::iota(g.y_begin / ty, (g.y_end + ty - 1) / ty);
+    auto tiles = std::views::cartesian_product(txs, tys);
+    return std::transform_reduce(std::execution::par, tiles.begin(), tiles.end(), 0., std::plus{},
+                                 [u_new, u_old, g, p](auto t) {
+      auto [i, j] = t;
+      auto x0 = std::max(i * tx, g.x_begin), x1 = std::min((i + 1) * tx, g.x_end);
+      auto y0 = std::max(j * ty, g.y_begin), y1 = std::min((j + 1) * ty, g.y_end);
+      double energy = 0.;
+      for (auto x = x0; x < x1; ++x) {
+        for (auto y = y0; y < y1; ++y) energy += stencil<S>(u_new, u_old, x, y, p);
+      }
+      return energy;
+    });
+  }
+}
+
+// Boundary conditions, imposed on the h cells around the domain that the stencil reads but never
+// writes.
+template <class Grid>
+void boundary_conditions(Grid u, parameters p) {
+  std::for_each_n(std::execution::par, std::views::iota(0L).begin(), p.nx + 2 * p.h,
+                  [u, p](long x) {
+    for (long y = 0; y < p.h; ++y) {
+      u(x, y) = 0;
+      u(x, p.ny - 1 - y) = 0;
+    }
+  });
+  // These boundary conditions are only imposed by the ranks at the end of the domain:
+  std::for_each_n(std::execution::par, std::views::iota(p.h).begin(), p.ny - 2 * p.h,
+                  [u, p](long y) {
+    for (long x = 0; x < p.h; ++x) {
+      if (p.rank == 0) u(x, y) = 1;
+      if (p.rank == (p.nranks - 1)) u(p.nx + p.h + x, y) = 0;
+    }
+  });
+}
+
+// Initial condition
+template <class Grid>
+void initial_condition(Grid u_new, Grid u_old, parameters p) {
+  std::fill_n(std::execution::par, u_old.data_handle(), u_old.mapping().required_span_size(), 0.0);
+  std::fill_n(std::execution::par, u_new.data_handle(), u_new.mapping().required_span_size(), 0.0);
+  boundary_conditions(u_old, p);
+  boundary_conditions(u_new, p);
+}
+
+// Exchanges the h rows next to each neighboring rank. With layout_right, rows are contiguous, so
+// each halo is sent and received in place as a single message of h * ny cells. Other layouts
+// scatter the rows over the tiles, so the halos are packed into buffers.
+template <class Grid>
+void exchange_halos(Grid u, parameters p) {
+  int count = (int)(p.h * p.ny);
+  if constexpr (std::is_same_v<typename Grid::layout_type, std::layout_right>) {
+    if (p.rank > 0) {
+      MPI_Sendrecv(&u(p.h, 0), count, MPI_DOUBLE, p.rank - 1, 0,
+                   &u(0, 0), count, MPI_DOUBLE, p.rank - 1, 0,
+                   MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+    if (p.rank < p.nranks - 1) {
+      MPI_Sendrecv(&u(p.nx, 0), count, MPI_DOUBLE, p.rank + 1, 0,
+                   &u(p.nx + p.h, 0), count, MPI_DOUBLE, p.rank + 1, 0,
+                   MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+  } else {
+    thread_local std::vector<double> halo_tx, halo_rx;
+    halo_tx.resize(count);
+    halo_rx.resize(count);
+    // Sends the rows [send_x, send_x + h) and receives the rows [recv_x, recv_x + h):
+    auto exchange = [u, p, count, tx = halo_tx.data(), rx = halo_rx.data()](long send_x,
+                                                                            long recv_x, int rank) {
+      auto ids = std::views::iota(0, count);
+      std::for_each(std::execution::par, ids.begin(), ids.end(), [u, p, tx, send_x](int k) {
+        tx[k] = u(send_x + k / p.ny, k % p.ny);
+      });
+      MPI_Sendrecv(tx, count, MPI_DOUBLE, rank, 0, rx, count, MPI_DOUBLE, rank, 0, MPI_COMM_WORLD,
+                   MPI_STATUS_IGNORE);
+      std::for_each(std::execution::par, ids.begin(), ids.end(), [u, p, rx, recv_x](int k) {
+        u(recv_x + k / p.ny, k % p.ny) = rx[k];
+      });
+    };
+    if (p.rank > 0) exchange(p.h, 0, p.rank - 1);
+    if (p.rank < p.nranks - 1) exchange(p.nx, p.nx + p.h, p.rank + 1);
+  }
+}
+
+// Solves the heat equation with the stencil "S" on grids of layout "Layout" and reports its
+// bandwidth.
+template <class S, class Layout>
+void run(std::string name, parameters p) {
+  static_assert(hpc::stencil_rank<S> == 2);
+  // The halo width follows the stencil, and the time step keeps p.gamma() * |S| = 1.6 < 2, which
+  // is the time step of the other exercises for the 5-point stencil:
+  p.h = hpc::halo_width<S>();
+  p.dt = 1.6 * p.dx * p.dx / (p.alpha() * hpc::stencil_norm<S>());
+  if (p.nx < p.h || p.ny <= 2 * p.h) {
+    if (p.rank == 0) std::cerr << "ERROR: domain too small for the " << name << " stencil\n";
+    std::terminate();
+  }
+
+  // The blocked and Morton layouts round the extents up, so the grids may need more than p.n():
+  using mapping_t = typename Layout::template mapping<std::dextents<std::size_t, 2>>;
+  auto mapping = mapping_t(std::dextents<std::size_t, 2>(p.nx + 2 * p.h, p.ny));
+  std::vector<double> u_new_data(mapping.required_span_size()),
+    u_old_data(mapping.required_span_size());
+  grid_t<Layout> u_new{u_new_data.data(), mapping};
+  grid_t<Layout> u_old{u_old_data.data(), mapping};
+  initial_condition(u_new, u_old, p);
+
+  using clk_t = std::chrono::steady_clock;
+  auto start = clk_t::now();
+  double energy = 0.;
+  for (long it = 0; it < p.nit(); ++it) {
+    exchange_halos(u_old, p);
+    grid g{.x_begin = p.h, .x_end = p.nx + p.h, .y_begin = p.h, .y_end = p.ny - p.h};
+    energy = apply_stencil<S>(u_new, u_old, g, p);
+    MPI_Reduce(p.rank == 0 ? MPI_IN_PLACE : &energy, &energy, 1, MPI_DOUBLE, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+    if (p.rank == 0 && it % p.nout() == 0) {
+      std::cerr << name << ": E(t=" << it * p.dt << ") = " << energy << std::endl;
+    }
+    std::swap(u_new, u_old);
+  }
+  auto time = std::chrono::duration<double>(clk_t::now() - start).count();
+  auto grid_size = static_cast<double>(p.nx * p.ny * sizeof(double) * 2) * 1e-9; // GB
+  auto memory_bw = grid_size * static_cast<double>(p.nit()) / time;             // GB/s
+  if (p.rank == 0) {
+    std::cerr << name << ": E(t=" << (p.nit() - 1) * p.dt << ") = " << energy << ", halo width "
+              << p.h << ", " << S::points.size() << " points: " << memory_bw * p.nranks << " GB/s, "
+              << time / p.nit() * 1e3 << " ms/step" << std::endl;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  // Parse CLI parameters
+  parameters p(argc, argv);
+
+  // Initialize MPI with multi-threading support
+  int mt;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mt);
+  if (mt != MPI_THREAD_MULTIPLE) {
+    std::cerr << "MPI cannot be called from multiple host threads" << std::endl;
+    std::terminate();
+  }
+  MPI_Comm_size(MPI_COMM_WORLD, &p.nranks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &p.rank);
+
+  if (p.rank == 0) {
+    std::cerr << "Global domain " << p.nx_global() << "x" << p.ny_global() << ", " << p.nit()
+              << " time steps" << std::endl;
+  }
+  // Each stencil on row-major, blocked and Morton-ordered grids:
+  run<hpc::five_point, std::layout_right>("5-point", p);
+  run<hpc::five_point, hpc::layout_blocked<32, 32>>("5-point blocked", p);
+  run<hpc::five_point, hpc::layout_morton>("5-point morton", p);
+  run<hpc::nine_point, std::layout_right>("9-point", p);
+  run<hpc::nine_point, hpc::layout_blocked<32, 32>>("9-point blocked", p);
+  run<hpc::nine_point, hpc::layout_morton>("9-point morton", p);
+  run<hpc::thirteen_point, std::layout_right>("13-point", p);
+  run<hpc::thirteen_point, hpc::layout_blocked<32, 32>>("13-point blocked", p);
+  run<hpc::thirteen_point, hpc::layout_morton>("13-point morton", p);
+
+  MPI_Finalize();
+  return 0;
+}
+
+// Reads command line arguments to initialize problem size
+parameters::parameters(int argc, char *argv[]) {
+  if (argc != 4) {
+    std::cerr << "ERROR: incorrect arguments" << std::endl;
+    std::cerr << "  " << argv[0] << " <nx> <ny> <ni>" << std::endl;
+    std::terminate();
+  }
+  nx = std::stoll(argv[1]);
+  ny = std::stoll(argv[2]);
+  ni = std::stoll(argv[3]);
+  h = 1;
+  dx = 1.0 / nx;
+  dt = dx * dx / (5. * alpha());
+}
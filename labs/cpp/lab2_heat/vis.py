@@ -5,15 +5,17 @@ import matplotlib.pyplot as plt
 
 def visualize(name = 'output'):
     f = open(name, 'rb')
-    grid = np.fromfile(f, dtype=np.uint64, count=2, offset=0)
+    header = np.fromfile(f, dtype=np.uint64, count=3, offset=0)
 
-    nx = grid[0]
-    ny = grid[1]
+    nx = header[0]
+    ny = header[1]
+    # The values are double or float, depending on the precision of the run:
+    dtype = {8: np.float64, 4: np.float32}[int(header[2])]
 
     times = np.fromfile(f, dtype=np.float64, count=1, offset=0)
     time = times[0]
 
-    values = np.fromfile(f, dtype=np.float64, offset=0)
+    values = np.fromfile(f, dtype=dtype, offset=0)
     assert len(values) == nx * ny, f'{len(values)} != {nx * ny}'
     values = values.reshape((nx, ny))
 